@@ -0,0 +1,411 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "AmorBus.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+namespace
+{
+    thread_local char lastErrorMessage[256] = "";
+
+    std::uint64_t nanoseconds(std::chrono::steady_clock::duration d)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    }
+
+    double systemTime()
+    {
+        return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    std::size_t lane(AmorBus::priority level)
+    {
+        return static_cast<std::size_t>(level);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorBus::parsePriority(const std::string & name, priority & level)
+{
+    if (name == "safety")
+    {
+        level = priority::SAFETY;
+    }
+    else if (name == "high")
+    {
+        level = priority::HIGH;
+    }
+    else if (name == "normal")
+    {
+        level = priority::NORMAL;
+    }
+    else if (name == "low")
+    {
+        level = priority::LOW;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+AmorBus::AmorBus(AMOR_HANDLE handle, time_source_t now)
+    : handle(handle),
+      now(now ? now : systemTime)
+{}
+
+// -----------------------------------------------------------------------------
+
+AmorBus::~AmorBus()
+{
+    stop();
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorBus::start()
+{
+    if (running)
+    {
+        return true;
+    }
+
+    stopping = false;
+    invalidateReads();
+
+    try
+    {
+        worker = std::thread(&AmorBus::run, this);
+    }
+    catch (const std::system_error &)
+    {
+        return false;
+    }
+
+    running = true;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBus::stop()
+{
+    if (!worker.joinable())
+    {
+        return;
+    }
+
+    {
+        // new requests are serviced inline from now on
+        std::lock_guard lock(wakeMutex);
+        running = false;
+        stopping = true;
+    }
+
+    wakeCondition.notify_one();
+
+    // inline requests must not overlap with the I/O thread nor overtake queued ones
+    std::lock_guard lock(inlineMutex);
+    worker.join();
+
+    // requests pushed by submitters that saw the I/O thread still running
+    while (entering.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+
+    drain();
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBus::drain()
+{
+    invalidateReads();
+
+    for (auto & queue : queues)
+    {
+        while (MpscNode * node = queue.pop())
+        {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            service(static_cast<Request &>(*node));
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+const char * AmorBus::lastError()
+{
+    return lastErrorMessage;
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBus::captureError(char (&error)[ERROR_LENGTH])
+{
+    const char * message = amor_error();
+    std::strncpy(error, message ? message : "", ERROR_LENGTH - 1);
+    error[ERROR_LENGTH - 1] = '\0';
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT AmorBus::read(const source & origin, const char * site, read_kind kind, AMOR_VECTOR7 & values,
+                          double * start, double * end)
+{
+    ReadRequest req;
+    req.origin = origin;
+    req.site = site;
+    req.coalescable = true;
+    req.kind = kind;
+    req.values = &values;
+    submit(req);
+
+    if (start)
+    {
+        *start = req.start;
+    }
+
+    if (end)
+    {
+        *end = req.end;
+    }
+
+    return req.result;
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBus::invalidateReads()
+{
+    for (auto & cache : readCache)
+    {
+        cache.valid = false;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBus::submit(Request & req)
+{
+    req.posted = clock::now();
+
+    // pairs with the store in stop() so that either we see the I/O thread stopped or it waits for our push
+    entering.fetch_add(1);
+
+    if (!running.load())
+    {
+        entering.fetch_sub(1);
+        std::lock_guard lock(inlineMutex);
+        invalidateReads();
+        service(req);
+    }
+    else
+    {
+        queues[lane(req.origin.level)].push(&req);
+        pending.fetch_add(1);
+        entering.fetch_sub(1);
+
+        // pairs with the store in run() so that either we see the worker asleep or it sees our request
+        if (sleeping.load())
+        {
+            std::lock_guard lock(wakeMutex);
+            wakeCondition.notify_one();
+        }
+
+        std::unique_lock lock(req.doneMutex);
+        req.doneCondition.wait(lock, [&req] { return req.done; });
+    }
+
+    if (req.failed)
+    {
+        std::copy(std::begin(req.error), std::end(req.error), lastErrorMessage);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorBus::preempt(Request & req)
+{
+    const auto level = lane(req.origin.level);
+
+    if (req.origin.preemptible && req.posted < preemptedBefore[level])
+    {
+        std::snprintf(req.error, ERROR_LENGTH, "preempted by %s", preemptedBy[level]);
+        req.failed = true;
+
+        if (req.coalescable)
+        {
+            static_cast<ReadRequest &>(req).result = AMOR_FAILED;
+        }
+        else
+        {
+            req.cancel(req);
+        }
+
+        return true;
+    }
+
+    if (req.origin.preempting)
+    {
+        // anything of lower priority still queued was issued before us
+        for (auto i = level + 1; i < PRIORITIES; i++)
+        {
+            preemptedBefore[i] = req.posted;
+            preemptedBy[i] = req.site;
+        }
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBus::service(Request & req)
+{
+    const auto start = clock::now();
+    auto result = CallSiteStats::outcome::EXECUTED;
+
+    if (preempt(req))
+    {
+        result = CallSiteStats::outcome::PREEMPTED;
+    }
+    else if (req.coalescable)
+    {
+        if (serviceRead(static_cast<ReadRequest &>(req)))
+        {
+            result = CallSiteStats::outcome::COALESCED;
+        }
+    }
+    else
+    {
+        // anything might have changed the state of the arm
+        invalidateReads();
+        req.execute(req, handle);
+
+        if (req.failed)
+        {
+            captureError(req.error);
+        }
+    }
+
+    const auto end = clock::now();
+    const auto waitNs = nanoseconds(start - req.posted);
+    const auto serviceNs = nanoseconds(end - start);
+
+    stats.record(req.site, waitNs, serviceNs, result);
+    sourceStats.record(req.origin.name, waitNs, serviceNs, result);
+
+    // the submitter may destroy the request as soon as the mutex is released
+    std::lock_guard lock(req.doneMutex);
+    req.done = true;
+    req.doneCondition.notify_one();
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorBus::serviceRead(ReadRequest & req)
+{
+    auto & cache = readCache[static_cast<std::size_t>(req.kind)];
+
+    // only requests that were already waiting when the transaction began may share its result
+    const bool coalesced = cache.valid && req.posted <= cache.issued;
+
+    if (!coalesced)
+    {
+        cache.issued = clock::now();
+        cache.start = now();
+
+        switch (req.kind)
+        {
+        case read_kind::ACTUAL_POSITIONS:
+            cache.result = amor_get_actual_positions(handle, &cache.values);
+            break;
+        case read_kind::ACTUAL_VELOCITIES:
+            cache.result = amor_get_actual_velocities(handle, &cache.values);
+            break;
+        case read_kind::ACTUAL_CURRENTS:
+            cache.result = amor_get_actual_currents(handle, &cache.values);
+            break;
+        case read_kind::CARTESIAN_POSITION:
+            cache.result = amor_get_cartesian_position(handle, cache.values);
+            break;
+        }
+
+        cache.end = now();
+
+        if (cache.result != AMOR_SUCCESS)
+        {
+            captureError(cache.error);
+        }
+    }
+
+    std::copy(cache.values, cache.values + AMOR_NUM_JOINTS, *req.values);
+    std::copy(std::begin(cache.error), std::end(cache.error), req.error);
+    req.result = cache.result;
+    req.start = cache.start;
+    req.end = cache.end;
+    req.failed = cache.result != AMOR_SUCCESS;
+
+    cache.valid = true;
+    return coalesced;
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBus::run()
+{
+    while (true)
+    {
+        MpscNode * node = nullptr;
+
+        // strict priority, lower levels only run while higher ones are idle
+        for (auto & queue : queues)
+        {
+            if ((node = queue.pop()) != nullptr)
+            {
+                break;
+            }
+        }
+
+        if (node)
+        {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            service(static_cast<Request &>(*node));
+            continue;
+        }
+
+        if (pending.load() != 0)
+        {
+            std::this_thread::yield(); // a push is in progress
+            continue;
+        }
+
+        // reads are coalesced only while requests keep piling up
+        invalidateReads();
+
+        std::unique_lock lock(wakeMutex);
+
+        if (stopping)
+        {
+            break;
+        }
+
+        sleeping = true;
+        wakeCondition.wait(lock, [this] { return pending.load() != 0 || stopping; });
+        sleeping = false;
+    }
+}
+
+// -----------------------------------------------------------------------------
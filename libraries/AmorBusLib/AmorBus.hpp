@@ -0,0 +1,264 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_BUS_HPP__
+#define __AMOR_BUS_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <amor.h>
+
+#include "CallSiteStats.hpp"
+#include "MpscQueue.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorBusLib
+ * @brief Serializes all accesses to an AMOR handle through a single I/O thread.
+ *
+ * Callers post requests into lock-free queues and block until the result
+ * is available (call(), read()).
+ * Each request originates from a source, which determines its priority:
+ * there is one queue per priority level, and the I/O thread always services
+ * the highest non-empty one first. Within a level, requests are serviced in
+ * arrival order. Reads of the same kind that pile up while the bus is busy
+ * are coalesced, i.e. serviced with a single transaction as long as no
+ * other request sits between them.
+ *
+ * A preempting source (e.g. a stop command) cancels all requests of
+ * preemptible sources with a lower priority that were issued before it and
+ * are still queued, so that stale motion commands are not executed after
+ * the arm has been halted. Cancelled requests fail with an explanatory
+ * error message.
+ *
+ * The handle must not be used directly while the I/O thread is running.
+ * Requests issued while it is stopped are serviced by the calling thread.
+ */
+class AmorBus
+{
+public:
+    //! Time source for acquisition timestamps [s].
+    using time_source_t = double (*)();
+
+    //! Reads that may be coalesced.
+    enum class read_kind { ACTUAL_POSITIONS, ACTUAL_VELOCITIES, ACTUAL_CURRENTS, CARTESIAN_POSITION };
+
+    //! Request priorities, in decreasing order of precedence.
+    enum class priority { SAFETY, HIGH, NORMAL, LOW };
+
+    //! Origin of a request.
+    struct source
+    {
+        const char * name; //!< string literal, requests are accounted to it
+        priority level {priority::NORMAL};
+        bool preempting {false}; //!< cancels queued preemptible requests of lower priority
+        bool preemptible {false}; //!< may be cancelled by a preempting source
+    };
+
+    //! Parse a priority level ("safety", "high", "normal" or "low").
+    static bool parsePriority(const std::string & name, priority & level);
+
+    AmorBus(AMOR_HANDLE handle, time_source_t now);
+    ~AmorBus();
+
+    AmorBus(const AmorBus &) = delete;
+    AmorBus & operator=(const AmorBus &) = delete;
+
+    //! Launch the I/O thread.
+    bool start();
+
+    //! Join the I/O thread, requests still queued or issued concurrently are serviced by the caller.
+    void stop();
+
+    /**
+     * Run a callable on the I/O thread and wait for its result.
+     * @param origin source of the request.
+     * @param site call site the request is accounted to (string literal).
+     * @param fn callable taking the AMOR handle, must not return void. An
+     * AMOR_RESULT other than AMOR_SUCCESS is considered a failure, see
+     * lastError(). If preempted, AMOR_FAILED or a value-initialized result
+     * is returned instead (e.g. false).
+     */
+    template <typename Fn>
+    auto call(const source & origin, const char * site, Fn && fn)
+    {
+        using result_t = std::invoke_result_t<Fn &, AMOR_HANDLE>;
+        static_assert(!std::is_void_v<result_t>, "bus requests must return a value");
+
+        struct Task : Request
+        {
+            Fn & fn;
+            std::optional<result_t> result;
+
+            Task(Fn & fn) : fn(fn) {}
+
+            static void invoke(Request & req, AMOR_HANDLE handle)
+            {
+                auto & task = static_cast<Task &>(req);
+                task.result.emplace(task.fn(handle));
+                task.failed = isFailure(*task.result);
+            }
+
+            static void reject(Request & req)
+            {
+                static_cast<Task &>(req).result.emplace(failureValue<result_t>());
+            }
+        };
+
+        Task task(fn);
+        task.origin = origin;
+        task.site = site;
+        task.execute = &Task::invoke;
+        task.cancel = &Task::reject;
+        submit(task);
+        return std::move(*task.result);
+    }
+
+    /**
+     * Read a joint or cartesian state vector, possibly coalesced with other readers.
+     * @param start if not null, system time right before the transaction [s].
+     * @param end if not null, system time right after the transaction [s].
+     */
+    AMOR_RESULT read(const source & origin, const char * site, read_kind kind, AMOR_VECTOR7 & values,
+                     double * start = nullptr, double * end = nullptr);
+
+    //! Error message of the last failed request issued by the calling thread.
+    static const char * lastError();
+
+    //! Per call site queue and service latencies.
+    std::vector<CallSiteStats::Site> getStats() const
+    { return stats.get(); }
+
+    //! Per source queue and service latencies.
+    std::vector<CallSiteStats::Site> getSourceStats() const
+    { return sourceStats.get(); }
+
+    void resetStats()
+    { stats.reset(); sourceStats.reset(); }
+
+    std::string formatStats() const
+    { return stats.format(); }
+
+    std::string formatSourceStats() const
+    { return sourceStats.format(); }
+
+private:
+    static constexpr std::size_t ERROR_LENGTH = 256;
+    static constexpr std::size_t READ_KINDS = 4;
+    static constexpr std::size_t PRIORITIES = 4;
+
+    using clock = std::chrono::steady_clock;
+
+    struct Request : MpscNode
+    {
+        source origin {nullptr};
+        const char * site {nullptr};
+        void (*execute)(Request &, AMOR_HANDLE) {nullptr};
+        void (*cancel)(Request &) {nullptr}; //!< stores the result of a preempted request
+        bool coalescable {false}; //!< true for ReadRequest
+        clock::time_point posted;
+        bool failed {false};
+        char error[ERROR_LENGTH] {};
+
+        // the submitter sleeps on these
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        bool done {false};
+    };
+
+    struct ReadRequest : Request
+    {
+        read_kind kind;
+        AMOR_VECTOR7 * values;
+        AMOR_RESULT result {AMOR_FAILED};
+        double start {0.0};
+        double end {0.0};
+    };
+
+    struct ReadCache
+    {
+        bool valid {false};
+        clock::time_point issued; //!< right before the transaction
+        AMOR_VECTOR7 values;
+        AMOR_RESULT result;
+        double start;
+        double end;
+        char error[ERROR_LENGTH];
+    };
+
+    template <typename T>
+    static T failureValue()
+    {
+        if constexpr (std::is_same_v<T, AMOR_RESULT>)
+        {
+            return AMOR_FAILED;
+        }
+        else
+        {
+            return T{};
+        }
+    }
+
+    template <typename T>
+    static bool isFailure(const T & result)
+    {
+        if constexpr (std::is_same_v<T, AMOR_RESULT>)
+        {
+            return result != AMOR_SUCCESS;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    static void captureError(char (&error)[ERROR_LENGTH]);
+
+    void invalidateReads();
+    void drain(); // inline lock held, I/O thread joined
+    void submit(Request & req);
+    void service(Request & req);
+    bool preempt(Request & req);
+    bool serviceRead(ReadRequest & req);
+    void run();
+
+    AMOR_HANDLE handle;
+    time_source_t now;
+
+    MpscQueue queues[PRIORITIES];
+    std::atomic<std::size_t> pending {0};
+    std::atomic<std::size_t> entering {0}; // submitters that may still push into the queues
+    std::atomic<bool> running {false};
+    std::atomic<bool> stopping {false};
+    std::atomic<bool> sleeping {false};
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::thread worker;
+
+    // serializes requests while the I/O thread is not running
+    std::mutex inlineMutex;
+
+    // I/O thread only
+    ReadCache readCache[READ_KINDS];
+    clock::time_point preemptedBefore[PRIORITIES] {};
+    const char * preemptedBy[PRIORITIES] {};
+
+    CallSiteStats stats;
+    CallSiteStats sourceStats;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_BUS_HPP__
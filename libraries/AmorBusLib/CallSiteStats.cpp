@@ -0,0 +1,138 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "CallSiteStats.hpp"
+
+#include <cstring>
+
+#include <iomanip>
+#include <sstream>
+
+using namespace roboticslab;
+
+namespace
+{
+    constexpr auto ANONYMOUS_SITE = "(unknown)";
+    constexpr auto OVERFLOW_SITE = "(other)";
+
+    std::size_t hash(const char * str)
+    {
+        std::size_t h = 2166136261u; // FNV-1a
+
+        while (*str)
+        {
+            h = (h ^ static_cast<unsigned char>(*str++)) * 16777619u;
+        }
+
+        return h;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+CallSiteStats::Slot & CallSiteStats::lookup(const char * site)
+{
+    if (!site)
+    {
+        site = ANONYMOUS_SITE;
+    }
+
+    // open addressing, the last slot is reserved for overflow
+    const std::size_t start = hash(site) % (MAX_SITES - 1);
+
+    for (std::size_t i = 0; i < MAX_SITES - 1; i++)
+    {
+        auto & slot = slots[(start + i) % (MAX_SITES - 1)];
+        const char * name = slot.name.load(std::memory_order_acquire);
+
+        if (!name && slot.name.compare_exchange_strong(name, site, std::memory_order_acq_rel))
+        {
+            return slot;
+        }
+
+        // literals with the same contents may live at different addresses (e.g. across plugins)
+        if (name == site || std::strcmp(name, site) == 0)
+        {
+            return slot;
+        }
+    }
+
+    auto & overflow = slots[MAX_SITES - 1];
+    const char * name = nullptr;
+    overflow.name.compare_exchange_strong(name, OVERFLOW_SITE, std::memory_order_acq_rel);
+    return overflow;
+}
+
+// -----------------------------------------------------------------------------
+
+void CallSiteStats::record(const char * site, std::uint64_t waitNs, std::uint64_t serviceNs, outcome result)
+{
+    auto & slot = lookup(site);
+    slot.wait.record(waitNs);
+    slot.service.record(serviceNs);
+
+    if (result == outcome::COALESCED)
+    {
+        slot.coalesced.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (result == outcome::PREEMPTED)
+    {
+        slot.preempted.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+std::vector<CallSiteStats::Site> CallSiteStats::get() const
+{
+    std::vector<Site> stats;
+
+    for (const auto & slot : slots)
+    {
+        if (const char * name = slot.name.load(std::memory_order_acquire); name)
+        {
+            stats.push_back({name, slot.coalesced.load(std::memory_order_relaxed),
+                             slot.preempted.load(std::memory_order_relaxed), slot.wait.summarize(), slot.service.summarize()});
+        }
+    }
+
+    return stats;
+}
+
+// -----------------------------------------------------------------------------
+
+void CallSiteStats::reset()
+{
+    for (auto & slot : slots)
+    {
+        slot.coalesced.store(0, std::memory_order_relaxed);
+        slot.preempted.store(0, std::memory_order_relaxed);
+        slot.wait.reset();
+        slot.service.reset();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+std::string CallSiteStats::format() const
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+
+    for (const auto & s : get())
+    {
+        if (s.service.count == 0)
+        {
+            continue;
+        }
+
+        // durations in microseconds
+        oss << s.site << ": n=" << s.service.count << " coalesced=" << s.coalesced << " preempted=" << s.preempted
+            << " wait[p50/p99/max]=" << s.wait.p50 * 1e6 << "/" << s.wait.p99 * 1e6 << "/" << s.wait.max * 1e6
+            << " service[p50/p99/max]=" << s.service.p50 * 1e6 << "/" << s.service.p99 * 1e6 << "/" << s.service.max * 1e6
+            << "; ";
+    }
+
+    return oss.str();
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_CALL_SITE_STATS_HPP__
+#define __AMOR_CALL_SITE_STATS_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorBusLib
+ * @brief Per call site latency statistics of bus requests.
+ *
+ * Requests are attributed to a call site, usually the name of the interface
+ * method that issued them, or to the source they originate from. For each
+ * site, the time spent waiting in queue and the time spent being serviced
+ * are recorded into lock-free histograms, along with the number of requests
+ * that were coalesced with an identical one or preempted before reaching
+ * the bus. Sites are kept in a fixed-size open addressing table.
+ */
+class CallSiteStats
+{
+public:
+    static constexpr std::size_t MAX_SITES = 64;
+
+    //! How a request was serviced.
+    enum class outcome { EXECUTED, COALESCED, PREEMPTED };
+
+    //! Statistics of a single call site, durations in seconds.
+    struct Site
+    {
+        std::string site;
+        std::uint64_t coalesced;
+        std::uint64_t preempted;
+        LatencyHistogram::Summary wait;
+        LatencyHistogram::Summary service;
+    };
+
+    //! Account a request issued from a call site (must be a string literal or nullptr).
+    void record(const char * site, std::uint64_t waitNs, std::uint64_t serviceNs, outcome result);
+
+    //! Retrieve statistics of all call sites seen so far.
+    std::vector<Site> get() const;
+
+    //! Clear all statistics, call sites are preserved.
+    void reset();
+
+    //! Human-readable, single-line summary of all call sites.
+    std::string format() const;
+
+private:
+    struct Slot
+    {
+        std::atomic<const char *> name {nullptr};
+        std::atomic<std::uint64_t> coalesced {0};
+        std::atomic<std::uint64_t> preempted {0};
+        LatencyHistogram wait;
+        LatencyHistogram service;
+    };
+
+    Slot & lookup(const char * site);
+
+    std::array<Slot, MAX_SITES> slots;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_CALL_SITE_STATS_HPP__
@@ -0,0 +1,96 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "DeadmanWatchdog.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+bool DeadmanWatchdog::start()
+{
+    if (worker.joinable())
+    {
+        return false;
+    }
+
+    stopping = false;
+    worker = std::thread(&DeadmanWatchdog::run, this);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void DeadmanWatchdog::stop()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+        armed = false;
+    }
+
+    condition.notify_one();
+
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void DeadmanWatchdog::kick(double timeout)
+{
+    bool earlier;
+
+    {
+        std::lock_guard lock(mutex);
+        const auto next = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(timeout));
+        earlier = !armed || next < deadline;
+        deadline = next;
+        armed = true;
+    }
+
+    // a later deadline is picked up when the current one expires, an earlier one needs a wake-up
+    if (earlier)
+    {
+        condition.notify_one();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void DeadmanWatchdog::disarm()
+{
+    std::lock_guard lock(mutex);
+    armed = false;
+}
+
+// -----------------------------------------------------------------------------
+
+void DeadmanWatchdog::run()
+{
+    std::unique_lock lock(mutex);
+
+    while (!stopping)
+    {
+        if (!armed)
+        {
+            condition.wait(lock);
+            continue;
+        }
+
+        condition.wait_until(lock, deadline);
+
+        if (armed && !stopping && clock::now() >= deadline)
+        {
+            armed = false;
+            trips++;
+
+            lock.unlock();
+            onExpiry();
+            lock.lock();
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
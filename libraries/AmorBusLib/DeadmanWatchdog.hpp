@@ -0,0 +1,78 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_DEADMAN_WATCHDOG_HPP__
+#define __AMOR_DEADMAN_WATCHDOG_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorBusLib
+ * @brief Fires a handler if streamed commands stop arriving in time.
+ *
+ * The watchdog is armed by the first kick and disarmed either explicitly or
+ * when it fires. A kick that pushes the deadline forward doesn't wake the
+ * watchdog thread, hence it is cheap enough to be issued on every command;
+ * only an earlier deadline (e.g. a shorter timeout) needs a wake-up.
+ * The handler runs on the watchdog thread, typically to post a stop request
+ * to the bus; it should check whether the streamed command is still in
+ * effect, since the arm may have been commanded otherwise in the meantime.
+ */
+class DeadmanWatchdog
+{
+public:
+    explicit DeadmanWatchdog(std::function<void()> onExpiry)
+        : onExpiry(std::move(onExpiry))
+    {}
+
+    ~DeadmanWatchdog()
+    { stop(); }
+
+    DeadmanWatchdog(const DeadmanWatchdog &) = delete;
+    DeadmanWatchdog & operator=(const DeadmanWatchdog &) = delete;
+
+    //! Launch the watchdog thread.
+    bool start();
+
+    //! Join the watchdog thread, a pending deadline is dropped.
+    void stop();
+
+    //! Arm the watchdog or postpone its deadline, timeout counted from now [s].
+    void kick(double timeout);
+
+    //! Drop the pending deadline, if any.
+    void disarm();
+
+    //! Number of times the handler was fired.
+    std::uint64_t getTrips() const
+    { return trips.load(std::memory_order_relaxed); }
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    void run();
+
+    std::function<void()> onExpiry;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    clock::time_point deadline;
+    bool armed {false};
+    bool stopping {false};
+    std::thread worker;
+
+    std::atomic<std::uint64_t> trips {0};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_DEADMAN_WATCHDOG_HPP__
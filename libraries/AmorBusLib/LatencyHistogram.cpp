@@ -0,0 +1,98 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+namespace
+{
+    std::size_t bucketOf(std::uint64_t ns)
+    {
+        std::size_t i = 0;
+
+        while (ns > 1 && i < LatencyHistogram::BUCKETS - 1)
+        {
+            ns >>= 1;
+            i++;
+        }
+
+        return i;
+    }
+
+    double upperBound(std::size_t bucket)
+    {
+        return static_cast<double>(std::uint64_t(1) << (bucket + 1)) * 1e-9;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void LatencyHistogram::record(std::uint64_t ns)
+{
+    buckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(ns, std::memory_order_relaxed);
+
+    auto prev = max.load(std::memory_order_relaxed);
+
+    while (prev < ns && !max.compare_exchange_weak(prev, ns, std::memory_order_relaxed))
+    {}
+}
+
+// -----------------------------------------------------------------------------
+
+LatencyHistogram::Summary LatencyHistogram::summarize() const
+{
+    std::array<std::uint64_t, BUCKETS> snapshot;
+    std::uint64_t n = 0;
+
+    for (std::size_t i = 0; i < BUCKETS; i++)
+    {
+        snapshot[i] = buckets[i].load(std::memory_order_relaxed);
+        n += snapshot[i];
+    }
+
+    Summary summary {};
+    summary.count = n;
+    summary.total = total.load(std::memory_order_relaxed) * 1e-9;
+    summary.max = max.load(std::memory_order_relaxed) * 1e-9;
+
+    const std::uint64_t rank50 = (n + 1) / 2;
+    const std::uint64_t rank99 = n - n / 100;
+    std::uint64_t accumulated = 0;
+
+    for (std::size_t i = 0; i < BUCKETS && n != 0; i++)
+    {
+        auto prev = accumulated;
+        accumulated += snapshot[i];
+
+        if (prev < rank50 && accumulated >= rank50)
+        {
+            summary.p50 = std::min(upperBound(i), summary.max);
+        }
+
+        if (prev < rank99 && accumulated >= rank99)
+        {
+            summary.p99 = std::min(upperBound(i), summary.max);
+            break;
+        }
+    }
+
+    return summary;
+}
+
+// -----------------------------------------------------------------------------
+
+void LatencyHistogram::reset()
+{
+    for (auto & bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+
+    total.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
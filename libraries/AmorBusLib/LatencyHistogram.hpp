@@ -0,0 +1,54 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_LATENCY_HISTOGRAM_HPP__
+#define __AMOR_LATENCY_HISTOGRAM_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup amor_yarp_devices_libraries
+ * @defgroup AmorBusLib
+ * @brief Utilities shared by the AMOR devices to access the CAN bus.
+ */
+
+/**
+ * @ingroup AmorBusLib
+ * @brief Lock-free histogram of durations with power-of-two buckets.
+ *
+ * Bucket i counts durations in [2^i, 2^(i+1)) nanoseconds. Concurrent
+ * writers never block each other; readers get a consistent-enough view
+ * for diagnostic purposes.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t BUCKETS = 40; // up to ~18 minutes
+
+    //! Statistics derived from the histogram, durations in seconds.
+    struct Summary
+    {
+        std::uint64_t count;
+        double total;
+        double max;
+        double p50; //!< upper bound of the bucket holding the median
+        double p99; //!< upper bound of the bucket holding the 99th percentile
+    };
+
+    void record(std::uint64_t ns);
+    Summary summarize() const;
+    void reset();
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKETS> buckets {};
+    std::atomic<std::uint64_t> total {0};
+    std::atomic<std::uint64_t> max {0};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_LATENCY_HISTOGRAM_HPP__
@@ -0,0 +1,93 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_MPSC_QUEUE_HPP__
+#define __AMOR_MPSC_QUEUE_HPP__
+
+#include <atomic>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorBusLib
+ * @brief Intrusive, lock-free multiple-producer single-consumer queue.
+ *
+ * Based on Dmitry Vyukov's non-blocking MPSC node-based queue. Nodes must
+ * derive from MpscNode and outlive their stay in the queue. Producers are
+ * wait-free; the consumer may transiently see an empty queue while a push
+ * is in progress.
+ */
+struct MpscNode
+{
+    std::atomic<MpscNode *> next {nullptr};
+};
+
+class MpscQueue
+{
+public:
+    MpscQueue()
+        : head(&stub),
+          tail(&stub)
+    {}
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue & operator=(const MpscQueue &) = delete;
+
+    //! Enqueue a node, may be called from any thread.
+    void push(MpscNode * node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        MpscNode * prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    //! Dequeue the oldest node or nullptr, must be called from the consumer thread.
+    MpscNode * pop()
+    {
+        MpscNode * first = tail;
+        MpscNode * next = first->next.load(std::memory_order_acquire);
+
+        if (first == &stub)
+        {
+            if (!next)
+            {
+                return nullptr;
+            }
+
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next)
+        {
+            tail = next;
+            return first;
+        }
+
+        if (first != head.load(std::memory_order_acquire))
+        {
+            return nullptr; // a producer is halfway through push()
+        }
+
+        push(&stub);
+        next = first->next.load(std::memory_order_acquire);
+
+        if (next)
+        {
+            tail = next;
+            return first;
+        }
+
+        return nullptr;
+    }
+
+private:
+    std::atomic<MpscNode *> head;
+    MpscNode * tail; // consumer only
+    MpscNode stub;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_MPSC_QUEUE_HPP__
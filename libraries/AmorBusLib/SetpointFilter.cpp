@@ -0,0 +1,53 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SetpointFilter.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+void SetpointFilter::configure(double deadband, double keepAlive)
+{
+    this->deadband = std::max(deadband, 0.0);
+    this->keepAlive = keepAlive;
+    valid = false;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SetpointFilter::suppress(const AMOR_VECTOR7 & setpoints, unsigned int epoch, double now)
+{
+    if (keepAlive <= 0.0 || !valid || epoch != lastEpoch || now - lastTime >= keepAlive)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+    {
+        if (std::abs(setpoints[i] - last[i]) > deadband)
+        {
+            return false;
+        }
+    }
+
+    suppressedFrames.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SetpointFilter::sent(const AMOR_VECTOR7 & setpoints, unsigned int epoch, double now)
+{
+    std::copy(setpoints, setpoints + AMOR_NUM_JOINTS, last);
+    lastEpoch = epoch;
+    lastTime = now;
+    valid = true;
+
+    sentFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_SETPOINT_FILTER_HPP__
+#define __AMOR_SETPOINT_FILTER_HPP__
+
+#include <atomic>
+#include <cstdint>
+
+#include <amor.h>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorBusLib
+ * @brief Drops outgoing setpoint frames that would not change the arm's behavior.
+ *
+ * A frame is suppressed if it lies within a deadband around the last frame
+ * sent through this filter, no other motion command was issued in between
+ * (as told by a command epoch that increases with every command sent to the
+ * arm) and the last frame is not older than the keep-alive interval, after
+ * which it is sent anyway. Filtering is disabled by default. Frames must be
+ * checked and recorded from within bus requests; counters may be read from
+ * any thread.
+ */
+class SetpointFilter
+{
+public:
+    /**
+     * @param deadband maximum absolute difference per element, same units as the setpoints.
+     * @param keepAlive maximum time between consecutive frames [s], zero or negative disables filtering.
+     */
+    void configure(double deadband, double keepAlive);
+
+    //! Whether the frame may be skipped, counts it as suppressed if so.
+    bool suppress(const AMOR_VECTOR7 & setpoints, unsigned int epoch, double now);
+
+    //! Record a frame that was sent to the arm, along with the resulting command epoch.
+    void sent(const AMOR_VECTOR7 & setpoints, unsigned int epoch, double now);
+
+    //! Forget the last frame, e.g. after a stop or a failed write.
+    void reset()
+    { valid = false; }
+
+    std::uint64_t getSent() const
+    { return sentFrames.load(std::memory_order_relaxed); }
+
+    std::uint64_t getSuppressed() const
+    { return suppressedFrames.load(std::memory_order_relaxed); }
+
+    void resetCounters()
+    { sentFrames = 0; suppressedFrames = 0; }
+
+private:
+    double deadband {0.0};
+    double keepAlive {0.0};
+
+    bool valid {false};
+    AMOR_VECTOR7 last;
+    unsigned int lastEpoch {0};
+    double lastTime {0.0};
+
+    std::atomic<std::uint64_t> sentFrames {0};
+    std::atomic<std::uint64_t> suppressedFrames {0};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_SETPOINT_FILTER_HPP__
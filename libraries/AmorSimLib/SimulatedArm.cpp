@@ -0,0 +1,411 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SimulatedArm.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+#include <algorithm>
+#include <thread>
+
+using namespace roboticslab;
+
+namespace
+{
+    constexpr double MAX_STEP = 0.001; // [s]
+    constexpr double POSITION_TOLERANCE = 1e-4; // [rad]
+    constexpr double CARTESIAN_LINEAR_SPEED = 100.0; // [mm/s]
+    constexpr double CARTESIAN_ANGULAR_SPEED = 0.5; // [rad/s]
+    constexpr double CARTESIAN_TOLERANCE = 1e-3;
+    constexpr double CURRENT_PER_ACCELERATION = 100.0; // [mA/(rad/s^2)]
+    constexpr double CURRENT_PER_VELOCITY = 200.0; // [mA/(rad/s)]
+
+    double readEnv(const char * name, double fallback)
+    {
+        const char * value = std::getenv(name);
+        return value ? std::atof(value) : fallback;
+    }
+
+    double moveTowards(double value, double target, double maxDelta)
+    {
+        return value + std::clamp(target - value, -maxDelta, maxDelta);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+SimulatedArm::SimulatedArm()
+    : rng(static_cast<unsigned int>(readEnv("AMOR_SIM_SEED", 0))),
+      latencyMean(readEnv("AMOR_SIM_LATENCY_US", 0.0) * 1e-6),
+      latencyJitter(readEnv("AMOR_SIM_JITTER_US", 0.0) * 1e-6),
+      faultRate(readEnv("AMOR_SIM_FAULT_RATE", 0.0)),
+      x({400.0, 0.0, 300.0, 0.0, 0.0, 0.0}), // [mm], [rad]
+      lastUpdate(clock::now())
+{
+    // roughly resembles the limits of the real arm
+    const double limits[AMOR_NUM_JOINTS] = {2.9, 1.7, 2.9, 2.0, 2.9, 1.7, 2.9};
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        jointInfo[j].lowerJointLimit = -limits[j];
+        jointInfo[j].upperJointLimit = limits[j];
+        jointInfo[j].maxVelocity = 0.5;
+        jointInfo[j].maxAcceleration = 1.0;
+        jointInfo[j].maxCurrent = 2000.0;
+        jointModes[j] = mode::IDLE;
+    }
+
+    xRef = x;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::setLatency(double meanUs, double jitterUs)
+{
+    std::lock_guard lock(busMutex);
+    latencyMean = std::max(meanUs, 0.0) * 1e-6;
+    latencyJitter = std::max(jitterUs, 0.0) * 1e-6;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::setFaultRate(double probability)
+{
+    std::lock_guard lock(busMutex);
+    faultRate = std::clamp(probability, 0.0, 1.0);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::failNext(int n)
+{
+    std::lock_guard lock(busMutex);
+    pendingFaults = std::max(n, 0);
+}
+
+// -----------------------------------------------------------------------------
+
+unsigned long SimulatedArm::getCallCount() const
+{
+    return calls;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::delay()
+{
+    double latency = latencyMean;
+
+    if (latencyJitter > 0.0)
+    {
+        std::uniform_real_distribution<double> dist(-latencyJitter, latencyJitter);
+        latency += dist(rng);
+    }
+
+    if (latency > 0.0)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(latency));
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedArm::shouldFail()
+{
+    if (pendingFaults > 0)
+    {
+        pendingFaults--;
+        return true;
+    }
+
+    if (faultRate > 0.0)
+    {
+        std::bernoulli_distribution dist(faultRate);
+        return dist(rng);
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::advance()
+{
+    auto now = clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastUpdate).count();
+    lastUpdate = now;
+
+    while (elapsed > 0.0)
+    {
+        double dt = std::min(elapsed, MAX_STEP);
+        step(dt);
+        elapsed -= dt;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::step(double dt)
+{
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        stepJoint(j, dt);
+    }
+
+    stepCartesian(dt);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::stepJoint(int j, double dt)
+{
+    const auto & info = jointInfo[j];
+    const double prevQdot = qdot[j];
+    double target = 0.0;
+
+    switch (jointModes[j])
+    {
+    case mode::POSITION:
+    {
+        // fastest velocity that still allows to brake in time
+        double e = qRef[j] - q[j];
+        target = std::copysign(std::min(info.maxVelocity, std::sqrt(2.0 * info.maxAcceleration * std::abs(e))), e);
+        break;
+    }
+    case mode::VELOCITY:
+        target = std::clamp(qdotRef[j], -info.maxVelocity, info.maxVelocity);
+        break;
+    default:
+        target = 0.0; // idle, current and cartesian modes do not move joints
+        break;
+    }
+
+    qdot[j] = moveTowards(qdot[j], target, info.maxAcceleration * dt);
+    q[j] += qdot[j] * dt;
+
+    if (jointModes[j] == mode::POSITION && std::abs(qRef[j] - q[j]) < POSITION_TOLERANCE
+            && std::abs(qdot[j]) < info.maxAcceleration * dt)
+    {
+        q[j] = qRef[j];
+        qdot[j] = 0.0;
+    }
+
+    if (q[j] < info.lowerJointLimit || q[j] > info.upperJointLimit)
+    {
+        q[j] = std::clamp(q[j], info.lowerJointLimit, info.upperJointLimit);
+        qdot[j] = 0.0;
+    }
+
+    if (jointModes[j] == mode::CURRENT)
+    {
+        current[j] = currentRef[j];
+    }
+    else
+    {
+        double qdotdot = (qdot[j] - prevQdot) / dt;
+        current[j] = CURRENT_PER_ACCELERATION * qdotdot + CURRENT_PER_VELOCITY * qdot[j];
+        current[j] = std::clamp(current[j], -info.maxCurrent, info.maxCurrent);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::stepCartesian(double dt)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        const double speed = i < 3 ? CARTESIAN_LINEAR_SPEED : CARTESIAN_ANGULAR_SPEED;
+
+        switch (cartesianMode)
+        {
+        case mode::CARTESIAN_POSITION:
+            x[i] = moveTowards(x[i], xRef[i], speed * dt);
+            break;
+        case mode::CARTESIAN_VELOCITY:
+            x[i] += std::clamp(xdotRef[i], -speed, speed) * dt;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::getPositions(AMOR_VECTOR7 positions) const
+{
+    std::copy(q.begin(), q.end(), positions);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::getVelocities(AMOR_VECTOR7 velocities) const
+{
+    std::copy(qdot.begin(), qdot.end(), velocities);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::getCurrents(AMOR_VECTOR7 currents) const
+{
+    std::copy(current.begin(), current.end(), currents);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::getReqPositions(AMOR_VECTOR7 positions) const
+{
+    std::copy(qRef.begin(), qRef.end(), positions);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::getReqVelocities(AMOR_VECTOR7 velocities) const
+{
+    std::copy(qdotRef.begin(), qdotRef.end(), velocities);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::getReqCurrents(AMOR_VECTOR7 currents) const
+{
+    std::copy(currentRef.begin(), currentRef.end(), currents);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::getCartesianPosition(AMOR_VECTOR7 pose) const
+{
+    std::copy(x.begin(), x.end(), pose);
+    pose[6] = 0.0;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedArm::isMoving() const
+{
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        if (qdot[j] != 0.0 || (jointModes[j] == mode::POSITION && q[j] != qRef[j]))
+        {
+            return true;
+        }
+    }
+
+    if (cartesianMode == mode::CARTESIAN_VELOCITY)
+    {
+        return std::any_of(xdotRef.begin(), xdotRef.end(), [](double v) { return v != 0.0; });
+    }
+
+    if (cartesianMode == mode::CARTESIAN_POSITION)
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            if (std::abs(xRef[i] - x[i]) > CARTESIAN_TOLERANCE)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedArm::setPositions(const AMOR_VECTOR7 positions, std::string & error)
+{
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        if (positions[j] < jointInfo[j].lowerJointLimit || positions[j] > jointInfo[j].upperJointLimit)
+        {
+            error = "target position out of joint limits (joint " + std::to_string(j) + ")";
+            return false;
+        }
+    }
+
+    std::copy(positions, positions + AMOR_NUM_JOINTS, qRef.begin());
+    jointModes.fill(mode::POSITION);
+    cartesianMode = mode::IDLE;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedArm::setVelocities(const AMOR_VECTOR7 velocities, std::string & error)
+{
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        if (std::abs(velocities[j]) > jointInfo[j].maxVelocity)
+        {
+            error = "target velocity out of limits (joint " + std::to_string(j) + ")";
+            return false;
+        }
+    }
+
+    std::copy(velocities, velocities + AMOR_NUM_JOINTS, qdotRef.begin());
+    jointModes.fill(mode::VELOCITY);
+    cartesianMode = mode::IDLE;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool SimulatedArm::setCurrents(const AMOR_VECTOR7 currents, std::string & error)
+{
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        if (std::abs(currents[j]) > jointInfo[j].maxCurrent)
+        {
+            error = "target current out of limits (joint " + std::to_string(j) + ")";
+            return false;
+        }
+    }
+
+    std::copy(currents, currents + AMOR_NUM_JOINTS, currentRef.begin());
+    jointModes.fill(mode::CURRENT);
+    cartesianMode = mode::IDLE;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::setCartesianPositions(const AMOR_VECTOR7 pose)
+{
+    std::copy(pose, pose + 6, xRef.begin());
+    jointModes.fill(mode::IDLE);
+    cartesianMode = mode::CARTESIAN_POSITION;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::setCartesianVelocities(const AMOR_VECTOR7 twist)
+{
+    std::copy(twist, twist + 6, xdotRef.begin());
+    jointModes.fill(mode::IDLE);
+    cartesianMode = mode::CARTESIAN_VELOCITY;
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::controlledStop()
+{
+    // joints decelerate at their maximum rate while idle
+    jointModes.fill(mode::IDLE);
+    qRef = q;
+    qdotRef.fill(0.0);
+    currentRef.fill(0.0);
+    cartesianMode = mode::IDLE;
+    xRef = x;
+    xdotRef.fill(0.0);
+}
+
+// -----------------------------------------------------------------------------
+
+void SimulatedArm::emergencyStop()
+{
+    controlledStop();
+    qdot.fill(0.0);
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,120 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_SIMULATED_ARM_HPP__
+#define __AMOR_SIMULATED_ARM_HPP__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+
+#include "amor.h"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup amor_yarp_devices_libraries
+ * @defgroup AmorSimLib
+ * @brief Drop-in replacement for the AMOR API backed by a simple arm model.
+ */
+
+/**
+ * @ingroup AmorSimLib
+ * @brief Simulated AMOR arm behind a CAN-like serialized bus.
+ *
+ * Each joint is modeled as a double integrator driven by a trapezoidal
+ * profile (position mode) or a ramp toward the commanded velocity
+ * (velocity mode), subject to the limits reported by getJointInfo().
+ * Cartesian commands move a task-space pose that is decoupled from joint
+ * space. The state is advanced lazily on each transaction. Transactions
+ * are serialized, may be delayed by a configurable latency with jitter and
+ * may fail on purpose.
+ */
+class SimulatedArm
+{
+public:
+    SimulatedArm();
+
+    //! Run a transaction on the simulated bus, false on (injected) failure.
+    template <typename Fn>
+    bool transact(Fn && fn, std::string & error)
+    {
+        std::lock_guard lock(busMutex);
+        calls++;
+
+        delay();
+
+        if (shouldFail())
+        {
+            error = "simulated bus fault";
+            return false;
+        }
+
+        advance();
+        return fn(*this, error);
+    }
+
+    void setLatency(double meanUs, double jitterUs);
+    void setFaultRate(double probability);
+    void failNext(int calls);
+    unsigned long getCallCount() const;
+
+    // the following must be called from within a transaction
+
+    const AMOR_JOINT_INFO & getJointInfo(int joint) const
+    { return jointInfo[joint]; }
+
+    void getPositions(AMOR_VECTOR7 positions) const;
+    void getVelocities(AMOR_VECTOR7 velocities) const;
+    void getCurrents(AMOR_VECTOR7 currents) const;
+    void getReqPositions(AMOR_VECTOR7 positions) const;
+    void getReqVelocities(AMOR_VECTOR7 velocities) const;
+    void getReqCurrents(AMOR_VECTOR7 currents) const;
+    void getCartesianPosition(AMOR_VECTOR7 pose) const;
+    bool isMoving() const;
+
+    bool setPositions(const AMOR_VECTOR7 positions, std::string & error);
+    bool setVelocities(const AMOR_VECTOR7 velocities, std::string & error);
+    bool setCurrents(const AMOR_VECTOR7 currents, std::string & error);
+    void setCartesianPositions(const AMOR_VECTOR7 pose);
+    void setCartesianVelocities(const AMOR_VECTOR7 twist);
+    void controlledStop();
+    void emergencyStop();
+
+private:
+    enum class mode { IDLE, POSITION, VELOCITY, CURRENT, CARTESIAN_POSITION, CARTESIAN_VELOCITY };
+
+    using clock = std::chrono::steady_clock;
+
+    void delay();
+    bool shouldFail();
+    void advance();
+    void step(double dt);
+    void stepJoint(int j, double dt);
+    void stepCartesian(double dt);
+
+    std::mutex busMutex;
+    std::mt19937 rng;
+    double latencyMean {0.0};
+    double latencyJitter {0.0};
+    double faultRate {0.0};
+    int pendingFaults {0};
+    std::atomic<unsigned long> calls {0};
+
+    std::array<AMOR_JOINT_INFO, AMOR_NUM_JOINTS> jointInfo;
+    std::array<mode, AMOR_NUM_JOINTS> jointModes;
+    std::array<double, AMOR_NUM_JOINTS> q {}, qdot {}, current {};
+    std::array<double, AMOR_NUM_JOINTS> qRef {}, qdotRef {}, currentRef {};
+
+    mode cartesianMode {mode::IDLE};
+    std::array<double, 6> x, xRef, xdotRef {};
+
+    clock::time_point lastUpdate;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_SIMULATED_ARM_HPP__
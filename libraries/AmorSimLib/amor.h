@@ -0,0 +1,88 @@
+/* -*- mode:C; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*- */
+
+#ifndef __AMOR_SIM_AMOR_H__
+#define __AMOR_SIM_AMOR_H__
+
+/**
+ * @ingroup AmorSimLib
+ * @file amor.h
+ * @brief Subset of the AMOR API implemented by the simulated backend.
+ *
+ * Mirrors the declarations of the vendor header consumed by the YARP
+ * devices in this repository, so that they can be compiled and run
+ * against AmorSimLib without source changes.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AMOR_NUM_JOINTS 7
+
+typedef double real;
+typedef real AMOR_VECTOR7[AMOR_NUM_JOINTS];
+typedef void * AMOR_HANDLE;
+
+#define AMOR_INVALID_HANDLE ((AMOR_HANDLE)0)
+
+typedef enum
+{
+    AMOR_SUCCESS = 0,
+    AMOR_FAILED = -1
+} AMOR_RESULT;
+
+typedef enum
+{
+    AMOR_MOVEMENT_STATUS_UNKNOWN = -1,
+    AMOR_MOVEMENT_STATUS_MOVING = 0,
+    AMOR_MOVEMENT_STATUS_FINISHED = 1
+} amor_movement_status;
+
+typedef struct
+{
+    real lowerJointLimit; /* [rad] */
+    real upperJointLimit; /* [rad] */
+    real maxVelocity; /* [rad/s] */
+    real maxAcceleration; /* [rad/s^2] */
+    real maxCurrent; /* [mA] */
+} AMOR_JOINT_INFO;
+
+void amor_get_library_version(int * major, int * minor, int * build);
+const char * amor_error(void);
+
+AMOR_HANDLE amor_connect(char * libraryName, int can_port);
+AMOR_RESULT amor_release(AMOR_HANDLE handle);
+
+AMOR_RESULT amor_get_joint_info(AMOR_HANDLE handle, int joint, AMOR_JOINT_INFO * parameters);
+AMOR_RESULT amor_get_status(AMOR_HANDLE handle, int joint, int * status);
+
+AMOR_RESULT amor_get_actual_positions(AMOR_HANDLE handle, AMOR_VECTOR7 * positions);
+AMOR_RESULT amor_get_actual_velocities(AMOR_HANDLE handle, AMOR_VECTOR7 * velocities);
+AMOR_RESULT amor_get_actual_currents(AMOR_HANDLE handle, AMOR_VECTOR7 * currents);
+
+AMOR_RESULT amor_get_req_positions(AMOR_HANDLE handle, AMOR_VECTOR7 * positions);
+AMOR_RESULT amor_get_req_velocities(AMOR_HANDLE handle, AMOR_VECTOR7 * velocities);
+AMOR_RESULT amor_get_req_currents(AMOR_HANDLE handle, AMOR_VECTOR7 * currents);
+
+AMOR_RESULT amor_set_positions(AMOR_HANDLE handle, AMOR_VECTOR7 positions);
+AMOR_RESULT amor_set_velocities(AMOR_HANDLE handle, AMOR_VECTOR7 velocities);
+AMOR_RESULT amor_set_currents(AMOR_HANDLE handle, AMOR_VECTOR7 currents);
+
+AMOR_RESULT amor_get_cartesian_position(AMOR_HANDLE handle, AMOR_VECTOR7 positions);
+AMOR_RESULT amor_set_cartesian_positions(AMOR_HANDLE handle, AMOR_VECTOR7 positions);
+AMOR_RESULT amor_set_cartesian_velocities(AMOR_HANDLE handle, AMOR_VECTOR7 velocities);
+
+AMOR_RESULT amor_get_movement_status(AMOR_HANDLE handle, amor_movement_status * status);
+
+AMOR_RESULT amor_controlled_stop(AMOR_HANDLE handle);
+AMOR_RESULT amor_emergency_stop(AMOR_HANDLE handle);
+
+AMOR_RESULT amor_open_hand(AMOR_HANDLE handle);
+AMOR_RESULT amor_close_hand(AMOR_HANDLE handle);
+AMOR_RESULT amor_stop_hand(AMOR_HANDLE handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AMOR_SIM_AMOR_H__ */
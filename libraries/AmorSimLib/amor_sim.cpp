@@ -0,0 +1,286 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "amor.h"
+#include "amor_sim.h"
+
+#include <string>
+
+#include "SimulatedArm.hpp"
+
+using namespace roboticslab;
+
+namespace
+{
+    thread_local std::string lastError;
+
+    AMOR_RESULT fail(const std::string & error)
+    {
+        lastError = error;
+        return AMOR_FAILED;
+    }
+
+    template <typename Fn>
+    AMOR_RESULT transact(AMOR_HANDLE handle, Fn && fn)
+    {
+        if (handle == AMOR_INVALID_HANDLE)
+        {
+            return fail("invalid handle");
+        }
+
+        std::string error;
+
+        if (!static_cast<SimulatedArm *>(handle)->transact(fn, error))
+        {
+            return fail(error);
+        }
+
+        return AMOR_SUCCESS;
+    }
+
+    template <typename Fn>
+    AMOR_RESULT configure(AMOR_HANDLE handle, Fn && fn)
+    {
+        if (handle == AMOR_INVALID_HANDLE)
+        {
+            return fail("invalid handle");
+        }
+
+        fn(*static_cast<SimulatedArm *>(handle));
+        return AMOR_SUCCESS;
+    }
+
+    template <typename Getter>
+    AMOR_RESULT readVector(AMOR_HANDLE handle, real * out, Getter getter)
+    {
+        if (!out)
+        {
+            return fail("null output vector");
+        }
+
+        return transact(handle, [out, getter](SimulatedArm & arm, std::string &) { (arm.*getter)(out); return true; });
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void amor_get_library_version(int * major, int * minor, int * build)
+{
+    *major = 0;
+    *minor = 1;
+    *build = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+const char * amor_error(void)
+{
+    return lastError.c_str();
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_HANDLE amor_connect(char * /*libraryName*/, int /*can_port*/)
+{
+    return new SimulatedArm;
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_release(AMOR_HANDLE handle)
+{
+    if (handle == AMOR_INVALID_HANDLE)
+    {
+        return fail("invalid handle");
+    }
+
+    delete static_cast<SimulatedArm *>(handle);
+    return AMOR_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_joint_info(AMOR_HANDLE handle, int joint, AMOR_JOINT_INFO * parameters)
+{
+    if (joint < 0 || joint >= AMOR_NUM_JOINTS)
+    {
+        return fail("joint index out of range");
+    }
+
+    return transact(handle, [joint, parameters](SimulatedArm & arm, std::string &)
+        {
+            *parameters = arm.getJointInfo(joint);
+            return true;
+        });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_status(AMOR_HANDLE handle, int joint, int * status)
+{
+    if (joint < 0 || joint >= AMOR_NUM_JOINTS)
+    {
+        return fail("joint index out of range");
+    }
+
+    return transact(handle, [status](SimulatedArm &, std::string &) { *status = 0; return true; });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_actual_positions(AMOR_HANDLE handle, AMOR_VECTOR7 * positions)
+{
+    return readVector(handle, *positions, &SimulatedArm::getPositions);
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_actual_velocities(AMOR_HANDLE handle, AMOR_VECTOR7 * velocities)
+{
+    return readVector(handle, *velocities, &SimulatedArm::getVelocities);
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_actual_currents(AMOR_HANDLE handle, AMOR_VECTOR7 * currents)
+{
+    return readVector(handle, *currents, &SimulatedArm::getCurrents);
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_req_positions(AMOR_HANDLE handle, AMOR_VECTOR7 * positions)
+{
+    return readVector(handle, *positions, &SimulatedArm::getReqPositions);
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_req_velocities(AMOR_HANDLE handle, AMOR_VECTOR7 * velocities)
+{
+    return readVector(handle, *velocities, &SimulatedArm::getReqVelocities);
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_req_currents(AMOR_HANDLE handle, AMOR_VECTOR7 * currents)
+{
+    return readVector(handle, *currents, &SimulatedArm::getReqCurrents);
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_set_positions(AMOR_HANDLE handle, AMOR_VECTOR7 positions)
+{
+    return transact(handle, [positions](SimulatedArm & arm, std::string & error) { return arm.setPositions(positions, error); });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_set_velocities(AMOR_HANDLE handle, AMOR_VECTOR7 velocities)
+{
+    return transact(handle, [velocities](SimulatedArm & arm, std::string & error) { return arm.setVelocities(velocities, error); });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_set_currents(AMOR_HANDLE handle, AMOR_VECTOR7 currents)
+{
+    return transact(handle, [currents](SimulatedArm & arm, std::string & error) { return arm.setCurrents(currents, error); });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_cartesian_position(AMOR_HANDLE handle, AMOR_VECTOR7 positions)
+{
+    return readVector(handle, positions, &SimulatedArm::getCartesianPosition);
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_set_cartesian_positions(AMOR_HANDLE handle, AMOR_VECTOR7 positions)
+{
+    return transact(handle, [positions](SimulatedArm & arm, std::string &) { arm.setCartesianPositions(positions); return true; });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_set_cartesian_velocities(AMOR_HANDLE handle, AMOR_VECTOR7 velocities)
+{
+    return transact(handle, [velocities](SimulatedArm & arm, std::string &) { arm.setCartesianVelocities(velocities); return true; });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_get_movement_status(AMOR_HANDLE handle, amor_movement_status * status)
+{
+    return transact(handle, [status](SimulatedArm & arm, std::string &)
+        {
+            *status = arm.isMoving() ? AMOR_MOVEMENT_STATUS_MOVING : AMOR_MOVEMENT_STATUS_FINISHED;
+            return true;
+        });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_controlled_stop(AMOR_HANDLE handle)
+{
+    return transact(handle, [](SimulatedArm & arm, std::string &) { arm.controlledStop(); return true; });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_emergency_stop(AMOR_HANDLE handle)
+{
+    return transact(handle, [](SimulatedArm & arm, std::string &) { arm.emergencyStop(); return true; });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_open_hand(AMOR_HANDLE handle)
+{
+    return transact(handle, [](SimulatedArm &, std::string &) { return true; });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_close_hand(AMOR_HANDLE handle)
+{
+    return transact(handle, [](SimulatedArm &, std::string &) { return true; });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_stop_hand(AMOR_HANDLE handle)
+{
+    return transact(handle, [](SimulatedArm &, std::string &) { return true; });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_sim_set_latency(AMOR_HANDLE handle, double mean_us, double jitter_us)
+{
+    return configure(handle, [mean_us, jitter_us](SimulatedArm & arm) { arm.setLatency(mean_us, jitter_us); });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_sim_set_fault_rate(AMOR_HANDLE handle, double probability)
+{
+    return configure(handle, [probability](SimulatedArm & arm) { arm.setFaultRate(probability); });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_sim_fail_next(AMOR_HANDLE handle, int calls)
+{
+    return configure(handle, [calls](SimulatedArm & arm) { arm.failNext(calls); });
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT amor_sim_get_call_count(AMOR_HANDLE handle, unsigned long * count)
+{
+    return configure(handle, [count](SimulatedArm & arm) { *count = arm.getCallCount(); });
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,33 @@
+/* -*- mode:C; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*- */
+
+#ifndef __AMOR_SIM_AMOR_SIM_H__
+#define __AMOR_SIM_AMOR_SIM_H__
+
+/**
+ * @ingroup AmorSimLib
+ * @file amor_sim.h
+ * @brief Simulation-only extensions to the AMOR API.
+ *
+ * Default values are read from the environment on amor_connect():
+ * - AMOR_SIM_LATENCY_US: mean duration of each bus transaction [us]
+ * - AMOR_SIM_JITTER_US: maximum deviation from the mean latency [us]
+ * - AMOR_SIM_FAULT_RATE: probability of a transaction failing, in [0, 1]
+ * - AMOR_SIM_SEED: seed of the random generator behind jitter and faults
+ */
+
+#include "amor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+AMOR_RESULT amor_sim_set_latency(AMOR_HANDLE handle, double mean_us, double jitter_us);
+AMOR_RESULT amor_sim_set_fault_rate(AMOR_HANDLE handle, double probability);
+AMOR_RESULT amor_sim_fail_next(AMOR_HANDLE handle, int calls);
+AMOR_RESULT amor_sim_get_call_count(AMOR_HANDLE handle, unsigned long * count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AMOR_SIM_AMOR_SIM_H__ */
@@ -4,14 +4,20 @@
 
 #include <cmath>
 
+#include <algorithm>
+
 #include <yarp/os/Log.h>
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Time.h>
 
+#include "KinematicRepresentation.hpp"
 #include "LogComponent.hpp"
 
 using namespace roboticslab;
 
 // -----------------------------------------------------------------------------
 
+
 bool AmorCartesianControl::checkJointVelocities(const std::vector<double> & qdot)
 {
     for (unsigned int i = 0; i < qdot.size(); i++)
@@ -27,3 +33,287 @@ bool AmorCartesianControl::checkJointVelocities(const std::vector<double> & qdot
 }
 
 // -----------------------------------------------------------------------------
+
+bool AmorCartesianControl::readJoints(const AmorBus::source & origin, std::vector<double> & q)
+{
+    AMOR_VECTOR7 positions;
+
+    if (bus->read(origin, __func__, AmorBus::read_kind::ACTUAL_POSITIONS, positions) != AMOR_SUCCESS)
+    {
+        yCError(ACC) << "amor_get_actual_positions() failed:" << AmorBus::lastError();
+        return false;
+    }
+
+    q.resize(AMOR_NUM_JOINTS);
+
+    for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+    {
+        q[i] = KinRepresentation::radToDeg(positions[i]);
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+double AmorCartesianControl::predictDuration(const std::vector<double> & q, const std::vector<double> & qd) const
+{
+    double duration = 0.0;
+
+    for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+    {
+        if (qdotMax[i] > 0.0)
+        {
+            duration = std::max(duration, std::abs(qd[i] - q[i]) / qdotMax[i]);
+        }
+    }
+
+    return duration;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorCartesianControl::moveJoints(const char * site, const std::vector<double> & qd, double duration)
+{
+    AMOR_VECTOR7 positions;
+
+    for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+    {
+        positions[i] = KinRepresentation::degToRad(qd[i]);
+    }
+
+    auto res = bus->call(commandSource, site, [&](AMOR_HANDLE handle)
+        {
+            auto res = notifyMotion(amor_set_positions(handle, positions));
+
+            // registered on the bus thread, hence no status poll can be mistaken for this motion
+            if (res == AMOR_SUCCESS)
+            {
+                motionMonitor->expect(duration);
+            }
+
+            return res;
+        });
+
+    if (res != AMOR_SUCCESS)
+    {
+        yCError(ACC) << "amor_set_positions() failed:" << AmorBus::lastError();
+        return false;
+    }
+
+    currentState = VOCAB_CC_MOVJ_CONTROLLING;
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorCartesianControl::trackPose(const std::vector<double> & xd)
+{
+    auto & q = trackBuffers.q;
+    auto & qdot = trackBuffers.qdot;
+    auto & x = trackBuffers.x;
+    auto & xdot = trackBuffers.xdot;
+
+    if (!readJoints(streamSource, q))
+    {
+        return false;
+    }
+
+    if (!iCartesianSolver->fwdKin(q, x))
+    {
+        yCError(ACC) << "fwdKin() failed";
+        return false;
+    }
+
+    if (!iCartesianSolver->poseDiff(xd, x, xdot))
+    {
+        yCError(ACC) << "poseDiff() failed";
+        return false;
+    }
+
+    // correct a fixed fraction of the pose error per period
+    const double factor = gain / posePeriod;
+
+    for (auto & v : xdot)
+    {
+        v *= factor;
+    }
+
+    if (!iCartesianSolver->diffInvKin(q, xdot, qdot, ICartesianSolver::BASE_FRAME))
+    {
+        yCError(ACC) << "diffInvKin() failed";
+        return false;
+    }
+
+    if (!checkJointVelocities(qdot))
+    {
+        bus->call(safetySource, __func__, [this](AMOR_HANDLE handle) { return notifyMotion(amor_controlled_stop(handle)); });
+        return false;
+    }
+
+    AMOR_VECTOR7 velocities;
+
+    for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+    {
+        velocities[i] = KinRepresentation::degToRad(qdot[i]);
+    }
+
+    return sendLoopFrame(*poseTracker, __func__, poseFilter, amor_set_velocities, velocities);
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorCartesianControl::controlForce(const std::vector<double> & w)
+{
+    auto & q = forceBuffers.q;
+    auto & zeros = forceBuffers.qdot; // the arm is assumed at rest
+    auto & t = forceBuffers.t;
+
+    if (!readJoints(streamSource, q))
+    {
+        return false;
+    }
+
+    // gravity torques, plus those that exert the wrench at the TCP (if any)
+    if (!iCartesianSolver->invDyn(q, zeros, zeros, w, t, referenceFrame))
+    {
+        yCError(ACC) << "invDyn() failed";
+        return false;
+    }
+
+    AMOR_VECTOR7 currents;
+
+    for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+    {
+        currents[i] = t[i] / torqueConstants[i] * 1000.0; // [mA]
+
+        if (std::abs(currents[i]) > currentMax[i])
+        {
+            yCError(ACC, "Maximum current hit: current[%d] = %f > %f [mA]", i, currents[i], currentMax[i]);
+            bus->call(safetySource, __func__, [this](AMOR_HANDLE handle) { return notifyMotion(amor_controlled_stop(handle)); });
+            return false;
+        }
+    }
+
+    return sendLoopFrame(*forceLoop, __func__, forceFilter, amor_set_currents, currents);
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorCartesianControl::armLoop(ControlLoop & loop, const std::vector<double> & reference)
+{
+    for (auto * other : {poseTracker.get(), forceLoop.get()})
+    {
+        if (other && other != &loop)
+        {
+            other->disarm();
+        }
+    }
+
+    // publish before the first cycle, else sendLoopFrame() would find itself superseded
+    {
+        std::lock_guard lock(loopMutex);
+        activeLoop = &loop;
+        loopEpoch = *commandCounter;
+    }
+
+    loop.setReference(reference); // starts the loop if idle
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorCartesianControl::sendLoopFrame(const ControlLoop & loop, const char * site, SetpointFilter & filter,
+                                         setter_t setter, AMOR_VECTOR7 & setpoints)
+{
+    bool superseded = false;
+
+    AMOR_RESULT res = bus->call(streamSource, site, [&](AMOR_HANDLE handle)
+        {
+            std::lock_guard lock(loopMutex);
+
+            // any other motion command, including a stop, ends the loop
+            if (activeLoop != &loop || *commandCounter != loopEpoch)
+            {
+                superseded = true;
+                return AMOR_SUCCESS;
+            }
+
+            AMOR_RESULT sent = sendStreamed(filter, setter, handle, setpoints);
+            loopEpoch = *commandCounter;
+            return sent;
+        });
+
+    if (superseded)
+    {
+        return false;
+    }
+
+    if (res != AMOR_SUCCESS)
+    {
+        yCError(ACC) << site << "failed:" << AmorBus::lastError();
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT AmorCartesianControl::notifyMotion(AMOR_RESULT res)
+{
+    if (commandCounter)
+    {
+        (*commandCounter)++;
+    }
+
+    return res;
+}
+
+// -----------------------------------------------------------------------------
+
+AMOR_RESULT AmorCartesianControl::sendStreamed(SetpointFilter & filter, setter_t setter, AMOR_HANDLE handle,
+                                               AMOR_VECTOR7 & setpoints)
+{
+    const double now = yarp::os::Time::now();
+
+    if (filter.suppress(setpoints, *commandCounter, now))
+    {
+        return AMOR_SUCCESS;
+    }
+
+    AMOR_RESULT res = notifyMotion(setter(handle, setpoints));
+
+    if (res == AMOR_SUCCESS)
+    {
+        filter.sent(setpoints, *commandCounter, now);
+        streamEpoch = *commandCounter;
+    }
+    else
+    {
+        filter.reset();
+    }
+
+    return res;
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorCartesianControl::feedWatchdog(double timeout)
+{
+    if (!streamWatchdog)
+    {
+        return;
+    }
+
+    if (timeout > 0.0)
+    {
+        streamWatchdog->kick(timeout);
+    }
+    else
+    {
+        streamWatchdog->disarm();
+    }
+}
+
+// -----------------------------------------------------------------------------
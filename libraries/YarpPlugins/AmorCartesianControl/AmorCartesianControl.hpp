@@ -3,16 +3,25 @@
 #ifndef __AMOR_CARTESIAN_CONTROL_HPP__
 #define __AMOR_CARTESIAN_CONTROL_HPP__
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 #include <amor.h>
 
+#include <yarp/os/Vocab.h>
 #include <yarp/dev/DeviceDriver.h>
 #include <yarp/dev/PolyDriver.h>
 
+#include "AmorBus.hpp"
+#include "ControlLoop.hpp"
+#include "DeadmanWatchdog.hpp"
 #include "ICartesianControl.h"
 #include "ICartesianSolver.h"
+#include "IkSeedCache.hpp"
+#include "MotionStatusMonitor.hpp"
+#include "SetpointFilter.hpp"
 
 namespace roboticslab
 {
@@ -23,11 +32,99 @@ namespace roboticslab
  * @brief Contains roboticslab::AmorCartesianControl.
  */
 
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: duration of the last cartesian state query [s].
+ */
+constexpr int VOCAB_ACC_STAT_LATENCY = yarp::os::createVocab32('a','s','l');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: streamed setpoint frames (twist, movv, pose) sent to the arm.
+ */
+constexpr int VOCAB_ACC_SENT_FRAMES = yarp::os::createVocab32('a','f','s');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: streamed setpoint frames (twist, movv, pose) suppressed as redundant.
+ */
+constexpr int VOCAB_ACC_SUPPRESSED_FRAMES = yarp::os::createVocab32('a','f','x');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: calls to the inverse kinematics solver (inv, movj, pose).
+ */
+constexpr int VOCAB_ACC_IK_CALLS = yarp::os::createVocab32('a','i','c');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: inverse kinematics calls answered from the seed cache.
+ */
+constexpr int VOCAB_ACC_IK_CACHE_HITS = yarp::os::createVocab32('a','i','h');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: inverse kinematics calls solved from a cached seed.
+ */
+constexpr int VOCAB_ACC_IK_WARM_STARTS = yarp::os::createVocab32('a','i','w');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: inverse kinematics solver runs, including cold retries.
+ */
+constexpr int VOCAB_ACC_IK_ATTEMPTS = yarp::os::createVocab32('a','i','a');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: duration of the last inverse kinematics call [s].
+ */
+constexpr int VOCAB_ACC_IK_LAST_TIME = yarp::os::createVocab32('a','i','l');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: mean duration of inverse kinematics calls [s].
+ */
+constexpr int VOCAB_ACC_IK_MEAN_TIME = yarp::os::createVocab32('a','i','m');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: maximum duration of inverse kinematics calls [s].
+ */
+constexpr int VOCAB_ACC_IK_MAX_TIME = yarp::os::createVocab32('a','i','x');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: cycles run by the force control loop (gcmp, forc, wrench).
+ */
+constexpr int VOCAB_ACC_FORCE_LOOP_CYCLES = yarp::os::createVocab32('a','l','c');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: force control loop cycles delayed by more than half a period.
+ */
+constexpr int VOCAB_ACC_FORCE_LOOP_OVERRUNS = yarp::os::createVocab32('a','l','o');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: mean jitter of the force control loop [s].
+ */
+constexpr int VOCAB_ACC_FORCE_LOOP_MEAN_JITTER = yarp::os::createVocab32('a','l','m');
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Read-only parameter: maximum jitter of the force control loop [s].
+ */
+constexpr int VOCAB_ACC_FORCE_LOOP_MAX_JITTER = yarp::os::createVocab32('a','l','x');
+
 /**
  * @ingroup AmorCartesianControl
  * @brief The AmorCartesianControl class implements ICartesianControl.
  *
- * Uses the roll-pitch-yaw (RPY) angle representation.
+ * Uses the roll-pitch-yaw (RPY) angle representation. Streamed poses are
+ * tracked by a closed-loop differential inverse kinematics controller that
+ * sends joint velocities at a fixed rate. Gravity compensation and force
+ * control stream the currents that match the gravity torques, plus those
+ * that exert the requested wrench at the TCP, at a fixed rate too.
  */
 class AmorCartesianControl : public yarp::dev::DeviceDriver,
                              public ICartesianControl
@@ -59,18 +156,136 @@ public:
     bool close() override;
 
 private:
+    using setter_t = AMOR_RESULT (*)(AMOR_HANDLE, AMOR_VECTOR7);
+
     bool checkJointVelocities(const std::vector<double> & qdot);
 
+    /**
+     * Solve inverse kinematics, warm-starting from the seed cache if possible.
+     * @param xd target pose.
+     * @param qGuess scratch buffer for the initial guess [deg], holds either the cached
+     * seed or the measured joint positions on return.
+     * @param q solution [deg].
+     */
+    bool solveIk(const std::vector<double> & xd, std::vector<double> & qGuess, std::vector<double> & q);
+
+    //! Read the measured joint positions [deg], no allocations if already sized.
+    bool readJoints(const AmorBus::source & origin, std::vector<double> & q);
+
+    /**
+     * Send joint position targets.
+     * @param site caller name.
+     * @param qd joint targets [deg].
+     * @param duration predicted duration of the motion [s], zero if unknown.
+     */
+    bool moveJoints(const char * site, const std::vector<double> & qd, double duration = 0.0);
+
+    //! Lower bound of the time needed to travel between joint positions [deg] at maximum speed [s].
+    double predictDuration(const std::vector<double> & q, const std::vector<double> & qd) const;
+
+    //! Single pose tracking step towards the given pose, false to stop tracking.
+    bool trackPose(const std::vector<double> & xd);
+
+    //! Single force control step exerting the given wrench, false to stop the loop.
+    bool controlForce(const std::vector<double> & w);
+
+    //! Hand the arm over to a control loop with the given reference, stopping any other loop.
+    void armLoop(ControlLoop & loop, const std::vector<double> & reference);
+
+    /**
+     * Send a setpoint frame on behalf of a control loop, unless any other command
+     * superseded it since its last frame.
+     * @return false if superseded or failed, which ends the loop.
+     */
+    bool sendLoopFrame(const ControlLoop & loop, const char * site, SetpointFilter & filter,
+                       setter_t setter, AMOR_VECTOR7 & setpoints);
+
+    /**
+     * Count a motion command, so that setpoint filters and the joint controller
+     * sharing our bus (if any) notice. Must be called from within a bus request.
+     */
+    AMOR_RESULT notifyMotion(AMOR_RESULT res);
+
+    /**
+     * Send a streamed setpoint frame unless the filter deems it redundant.
+     * Must be called from within a bus request.
+     */
+    AMOR_RESULT sendStreamed(SetpointFilter & filter, setter_t setter, AMOR_HANDLE handle, AMOR_VECTOR7 & setpoints);
+
+    //! Arm or postpone the streaming watchdog with the given timeout [s], disarm it if zero.
+    void feedWatchdog(double timeout);
+
     AMOR_HANDLE handle {AMOR_INVALID_HANDLE};
     bool ownsHandle {true};
-    mutable std::mutex * handleMutex {nullptr};
+    std::unique_ptr<AmorBus> ownBus; // standalone mode
+    AmorBus * bus {nullptr}; // either ours or the joint controller's
+
+    // bus request origins, stops take precedence over (and cancel) pending commands
+    AmorBus::source safetySource {"AmorCartesianControl/safety", AmorBus::priority::SAFETY, true, false};
+    AmorBus::source streamSource {"AmorCartesianControl/stream", AmorBus::priority::HIGH, false, true};
+    AmorBus::source commandSource {"AmorCartesianControl/command", AmorBus::priority::NORMAL, false, true};
+    AmorBus::source monitorSource {"AmorCartesianControl/monitor", AmorBus::priority::LOW, false, false};
+    std::atomic<unsigned int> * commandCounter {nullptr};
+    std::atomic<unsigned int> ownCommandCounter {0}; // standalone mode
+
+    SetpointFilter twistFilter; // joint velocities
+    SetpointFilter movvFilter; // cartesian velocities
+    SetpointFilter poseFilter; // joint velocities
+    SetpointFilter forceFilter; // joint currents
+
+    // stops the arm if streaming clients fall silent, per-command timeouts [s]
+    std::unique_ptr<DeadmanWatchdog> streamWatchdog;
+    double twistTimeout {0.0};
+    double movvTimeout {0.0};
+    double wrenchTimeout {0.0};
+    unsigned int streamEpoch {0}; // command counter after the last streamed frame, bus thread only
 
     yarp::dev::PolyDriver cartesianDevice;
     ICartesianSolver * iCartesianSolver;
 
+    // recent inverse kinematics solutions, warm-start the solver in the base frame
+    IkSeedCache ikCache;
+
+    // scratch space of streaming commands (twist, movv, pose), sized in open() so
+    // that the steady-state path performs no heap allocations of its own (the
+    // kinematics solver, e.g. KdlSolver, may still allocate internally)
+    struct StreamBuffers
+    {
+        std::vector<double> q; // [deg]
+        std::vector<double> qGuess; // [deg]
+        std::vector<double> qdot; // [deg/s]
+        std::vector<double> x;
+        std::vector<double> xdot;
+        std::vector<double> t; // [Nm]
+    };
+
+    std::mutex streamMutex;
+    StreamBuffers streamBuffers;
+
+    // streamed poses only update the reference of the tracking loop, if enabled
+    std::unique_ptr<ControlLoop> poseTracker;
+    double posePeriod {0.0};
+    StreamBuffers trackBuffers; // loop thread only
+
+    // gcmp, forc and wrench only update the reference of the force loop, if enabled
+    std::unique_ptr<ControlLoop> forceLoop;
+    StreamBuffers forceBuffers; // loop thread only
+    std::vector<double> torqueConstants; // [Nm/A]
+    std::vector<double> currentMax; // [mA]
+
+    // at most one control loop drives the arm, until any other command supersedes it
+    std::mutex loopMutex;
+    const ControlLoop * activeLoop {nullptr};
+    unsigned int loopEpoch {0}; // command counter after the last frame sent by the active loop
+
     int currentState;
-    double gain;
+    std::atomic<double> gain;
     int waitPeriodMs;
+    int waitFinePeriodMs;
+
+    // polls the movement status on behalf of all clients blocked in wait()
+    std::unique_ptr<MotionStatusMonitor> motionMonitor;
+    std::atomic<double> statLatency {0.0};
 
     std::vector<double> qdotMax;
 
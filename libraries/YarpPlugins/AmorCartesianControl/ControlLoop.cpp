@@ -0,0 +1,108 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "ControlLoop.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+#include <yarp/os/Time.h>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+bool ControlLoop::setReference(const std::vector<double> & values)
+{
+    std::lock_guard lock(mutex);
+    reference.assign(values.begin(), values.end());
+
+    if (running)
+    {
+        return false;
+    }
+
+    running = true;
+    session++;
+    lastCycle = 0.0;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void ControlLoop::disarm()
+{
+    std::lock_guard lock(mutex);
+    running = false;
+}
+
+// -----------------------------------------------------------------------------
+
+bool ControlLoop::isRunning() const
+{
+    std::lock_guard lock(mutex);
+    return running;
+}
+
+// -----------------------------------------------------------------------------
+
+ControlLoop::Stats ControlLoop::getStats() const
+{
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+// -----------------------------------------------------------------------------
+
+void ControlLoop::resetStats()
+{
+    std::lock_guard lock(mutex);
+    stats = {};
+    totalJitter = 0.0;
+}
+
+// -----------------------------------------------------------------------------
+
+void ControlLoop::run()
+{
+    unsigned int current;
+
+    {
+        std::lock_guard lock(mutex);
+
+        if (!running)
+        {
+            return;
+        }
+
+        const double now = yarp::os::Time::now();
+
+        if (lastCycle != 0.0)
+        {
+            const double jitter = std::abs(now - lastCycle - period);
+
+            stats.cycles++;
+            stats.overruns += jitter > period / 2.0;
+            stats.maxJitter = std::max(stats.maxJitter, jitter);
+            totalJitter += jitter;
+            stats.meanJitter = totalJitter / stats.cycles;
+        }
+
+        lastCycle = now;
+        active.assign(reference.begin(), reference.end());
+        current = session;
+    }
+
+    if (!step(active))
+    {
+        std::lock_guard lock(mutex);
+
+        // don't stop a loop restarted in the meantime
+        if (session == current)
+        {
+            running = false;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_CONTROL_LOOP_HPP__
+#define __AMOR_CONTROL_LOOP_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <yarp/os/PeriodicThread.h>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Runs a control step at a fixed rate towards the last reference received.
+ *
+ * Clients only update the reference, at whatever rate they like; the loop
+ * starts with the first reference and runs until disarmed or until a step
+ * fails (e.g. because the command was superseded). Each step works on a
+ * private copy of the reference taken at the beginning of the cycle, and
+ * no allocations take place once the reference buffers have been sized.
+ * Cycle-to-cycle jitter is measured against the nominal period.
+ */
+class ControlLoop : public yarp::os::PeriodicThread
+{
+public:
+    //! Single control step, the loop stops if it returns false.
+    using step_t = std::function<bool(const std::vector<double> & reference)>;
+
+    //! Loop statistics, jitter in seconds.
+    struct Stats
+    {
+        unsigned long cycles;
+        unsigned long overruns; //!< cycles delayed by more than half a period
+        double meanJitter;
+        double maxJitter;
+    };
+
+    ControlLoop(double period, std::size_t size, step_t step)
+        : yarp::os::PeriodicThread(period),
+          period(period),
+          step(std::move(step))
+    { reference.reserve(size); active.reserve(size); }
+
+    /**
+     * Update the reference, start the loop if idle.
+     * @return true if the loop was idle.
+     */
+    bool setReference(const std::vector<double> & values);
+
+    //! Stop running control steps.
+    void disarm();
+
+    bool isRunning() const;
+
+    Stats getStats() const;
+
+    void resetStats();
+
+protected:
+    void run() override;
+
+private:
+    const double period;
+    const step_t step;
+
+    mutable std::mutex mutex;
+    std::vector<double> reference;
+    std::vector<double> active; // loop thread only
+    bool running {false};
+    unsigned int session {0};
+    double lastCycle {0.0};
+    double totalJitter {0.0};
+    Stats stats {};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_CONTROL_LOOP_HPP__
@@ -2,12 +2,15 @@
 
 #include "AmorCartesianControl.hpp"
 
+#include <cstring>
+
 #include <string>
 
 #include <yarp/os/Bottle.h>
 #include <yarp/os/LogStream.h>
 #include <yarp/os/Property.h>
 #include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Time.h>
 #include <yarp/os/Value.h>
 
 #include "KinematicRepresentation.hpp"
@@ -19,18 +22,48 @@ constexpr auto DEFAULT_CAN_LIBRARY = "libeddriver.so";
 constexpr auto DEFAULT_CAN_PORT = 0;
 constexpr auto DEFAULT_GAIN = 0.05;
 constexpr auto DEFAULT_WAIT_PERIOD_MS = 30;
+constexpr auto DEFAULT_WAIT_FINE_PERIOD_MS = 2;
 constexpr auto DEFAULT_REFERENCE_FRAME = "base";
+constexpr auto DEFAULT_STREAM_PRIORITY = "high";
+constexpr auto DEFAULT_COMMAND_PRIORITY = "normal";
+constexpr auto DEFAULT_MONITOR_PRIORITY = "low";
+constexpr auto DEFAULT_COMMAND_PREEMPTIBLE = true;
+constexpr auto DEFAULT_SETPOINT_KEEP_ALIVE = 0.0; // disabled
+constexpr auto DEFAULT_VELOCITY_DEADBAND = 0.0;
+constexpr auto DEFAULT_TWIST_TIMEOUT_MS = 0; // disabled
+constexpr auto DEFAULT_MOVV_TIMEOUT_MS = 0; // disabled
+constexpr auto DEFAULT_IK_CACHE_SIZE = 16;
+constexpr auto DEFAULT_IK_SEED_RADIUS = 0.1;
+constexpr auto DEFAULT_POSE_PERIOD_MS = 20;
+constexpr auto DEFAULT_FORCE_PERIOD_MS = 10;
+constexpr auto DEFAULT_WRENCH_TIMEOUT_MS = 0; // disabled
 
 // ------------------- DeviceDriver Related ------------------------------------
 
 bool AmorCartesianControl::open(yarp::os::Searchable& config)
 {
     gain = config.check("controllerGain", yarp::os::Value(DEFAULT_GAIN),
-            "controller gain").asFloat64();
+            "fraction of the pose error corrected per tracking period (posePeriodMs), in range (0, 1]").asFloat64();
+
+    // the discrete tracking loop freezes at zero and overshoots past one, diverging from two on
+    if (gain <= 0.0 || gain > 1.0)
+    {
+        yCError(ACC) << "Illegal controller gain:" << gain.load() << "(must be in range (0, 1])";
+        return false;
+    }
 
     waitPeriodMs = config.check("waitPeriodMs", yarp::os::Value(DEFAULT_WAIT_PERIOD_MS),
             "wait command period (milliseconds)").asInt32();
 
+    waitFinePeriodMs = config.check("waitFinePeriodMs", yarp::os::Value(DEFAULT_WAIT_FINE_PERIOD_MS),
+            "wait command period near the predicted end of motion (milliseconds)").asInt32();
+
+    if (waitPeriodMs <= 0 || waitFinePeriodMs <= 0)
+    {
+        yCError(ACC) << "Wait periods must be positive:" << waitPeriodMs << waitFinePeriodMs;
+        return false;
+    }
+
     auto referenceFrameStr = config.check("referenceFrame", yarp::os::Value(DEFAULT_REFERENCE_FRAME),
             "reference frame (base|tcp)").asString();
 
@@ -48,10 +81,47 @@ bool AmorCartesianControl::open(yarp::os::Searchable& config)
         return false;
     }
 
-    yarp::os::Value vHandle = config.find("handle");
-    yarp::os::Value vHandleMutex = config.find("handleMutex");
+    auto streamPriority = config.check("streamPriority", yarp::os::Value(DEFAULT_STREAM_PRIORITY),
+            "bus priority of streaming commands, i.e. twist and movv (safety, high, normal, low)").asString();
+
+    auto commandPriority = config.check("commandPriority", yarp::os::Value(DEFAULT_COMMAND_PRIORITY),
+            "bus priority of motion commands (safety, high, normal, low)").asString();
+
+    auto monitorPriority = config.check("monitorPriority", yarp::os::Value(DEFAULT_MONITOR_PRIORITY),
+            "bus priority of state queries (safety, high, normal, low)").asString();
 
-    if (vHandle.isNull() || vHandleMutex.isNull())
+    if (!AmorBus::parsePriority(streamPriority, streamSource.level)
+        || !AmorBus::parsePriority(commandPriority, commandSource.level)
+        || !AmorBus::parsePriority(monitorPriority, monitorSource.level))
+    {
+        yCError(ACC) << "Illegal bus priority:" << streamPriority << commandPriority << monitorPriority;
+        return false;
+    }
+
+    bool commandPreemptible = config.check("commandPreemptible", yarp::os::Value(DEFAULT_COMMAND_PREEMPTIBLE),
+            "whether queued motion commands are discarded by subsequent stops").asBool();
+
+    streamSource.preemptible = commandPreemptible;
+    commandSource.preemptible = commandPreemptible;
+
+    double setpointKeepAlive = config.check("setpointKeepAlive", yarp::os::Value(DEFAULT_SETPOINT_KEEP_ALIVE),
+            "resend period of unchanged streamed setpoints, redundant ones are suppressed (seconds, 0 to disable)").asFloat64();
+
+    double velocityDeadband = config.check("velocityDeadband", yarp::os::Value(DEFAULT_VELOCITY_DEADBAND),
+            "joint velocity deadband of twist commands (degrees/second)").asFloat64();
+
+    // movv setpoints mix linear and angular units, only exact duplicates are dropped
+    twistFilter.configure(KinRepresentation::degToRad(velocityDeadband), setpointKeepAlive);
+    poseFilter.configure(KinRepresentation::degToRad(velocityDeadband), setpointKeepAlive);
+    movvFilter.configure(0.0, setpointKeepAlive);
+    forceFilter.configure(0.0, setpointKeepAlive);
+
+    // replaced by the joint controller's counter if sharing its bus
+    commandCounter = &ownCommandCounter;
+
+    yarp::os::Value vBus = config.find("bus");
+
+    if (vBus.isNull())
     {
         yCInfo(ACC) << "Creating own AMOR handle";
 
@@ -62,40 +132,75 @@ bool AmorCartesianControl::open(yarp::os::Searchable& config)
 
         ownsHandle = true;
         handle = amor_connect(const_cast<char *>(canLibrary.c_str()), canPort);
-        handleMutex = new std::mutex;
+
+        if (handle == AMOR_INVALID_HANDLE)
+        {
+            yCError(ACC) << "Could not get AMOR handle:" << amor_error();
+            return false;
+        }
+
+        ownBus = std::make_unique<AmorBus>(handle, yarp::os::Time::now);
+        bus = ownBus.get();
+
+        if (!bus->start())
+        {
+            yCError(ACC) << "Unable to start AMOR bus thread";
+            return false;
+        }
     }
     else
     {
         yCInfo(ACC) << "Using external AMOR handle";
         ownsHandle = false;
-        handle = *reinterpret_cast<AMOR_HANDLE *>(const_cast<char *>(vHandle.asBlob()));
-        handleMutex = reinterpret_cast<std::mutex *>(const_cast<char *>(vHandleMutex.asBlob()));
+        bus = *reinterpret_cast<AmorBus **>(const_cast<char *>(vBus.asBlob()));
+
+        if (auto vCommandCounter = config.find("commandCounter"); !vCommandCounter.isNull())
+        {
+            commandCounter = *reinterpret_cast<std::atomic<unsigned int> **>(const_cast<char *>(vCommandCounter.asBlob()));
+        }
     }
 
-    if (std::lock_guard lock(*handleMutex); handle == AMOR_INVALID_HANDLE)
+    AMOR_JOINT_INFO jointInfo[AMOR_NUM_JOINTS];
+
+    // the joint controller may have queried this already, don't hit the bus again
+    if (auto vJointInfo = config.find("jointInfo"); vJointInfo.isBlob() && vJointInfo.asBlobLength() == sizeof(jointInfo))
     {
-        yCError(ACC) << "Could not get AMOR handle:" << amor_error();
-        return false;
+        std::memcpy(jointInfo, vJointInfo.asBlob(), sizeof(jointInfo));
+    }
+    else
+    {
+        bool ok = bus->call(monitorSource, __func__, [&jointInfo](AMOR_HANDLE handle)
+            {
+                for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+                {
+                    if (amor_get_joint_info(handle, i, &jointInfo[i]) != AMOR_SUCCESS)
+                    {
+                        yCError(ACC) << "amor_get_joint_info() failed:" << amor_error();
+                        return false;
+                    }
+                }
+
+                return true;
+            });
+
+        if (!ok)
+        {
+            return false;
+        }
     }
 
     qdotMax.resize(AMOR_NUM_JOINTS);
+    currentMax.resize(AMOR_NUM_JOINTS);
 
     yarp::os::Bottle qMin, qMax;
 
     for (int i = 0; i < AMOR_NUM_JOINTS; i++)
     {
-        AMOR_JOINT_INFO jointInfo;
-
-        if (std::lock_guard lock(*handleMutex); amor_get_joint_info(handle, i, &jointInfo) != AMOR_SUCCESS)
-        {
-            yCError(ACC) << "amor_get_joint_info() failed:" << amor_error();
-            return false;
-        }
-
-        qdotMax[i] = KinRepresentation::radToDeg(jointInfo.maxVelocity);
+        qdotMax[i] = KinRepresentation::radToDeg(jointInfo[i].maxVelocity);
+        currentMax[i] = jointInfo[i].maxCurrent;
 
-        qMin.addFloat64(KinRepresentation::radToDeg(jointInfo.lowerJointLimit));
-        qMax.addFloat64(KinRepresentation::radToDeg(jointInfo.upperJointLimit));
+        qMin.addFloat64(KinRepresentation::radToDeg(jointInfo[i].lowerJointLimit));
+        qMax.addFloat64(KinRepresentation::radToDeg(jointInfo[i].upperJointLimit));
     }
 
     yarp::os::ResourceFinder rf;
@@ -130,6 +235,152 @@ bool AmorCartesianControl::open(yarp::os::Searchable& config)
         return false;
     }
 
+    int ikCacheSize = config.check("ikCacheSize", yarp::os::Value(DEFAULT_IK_CACHE_SIZE),
+            "number of recent inverse kinematics solutions kept as solver seeds (0 to disable)").asInt32();
+
+    double ikSeedRadius = config.check("ikSeedRadius", yarp::os::Value(DEFAULT_IK_SEED_RADIUS),
+            "maximum pose distance to a cached solution for it to seed the solver (meters and radians alike)").asFloat64();
+
+    if (ikCacheSize < 0 || ikSeedRadius < 0.0)
+    {
+        yCError(ACC) << "Illegal inverse kinematics cache parameters:" << ikCacheSize << ikSeedRadius;
+        return false;
+    }
+
+    ikCache.configure(ikCacheSize, ikSeedRadius);
+
+    streamBuffers.q.resize(AMOR_NUM_JOINTS);
+    streamBuffers.qGuess.resize(AMOR_NUM_JOINTS);
+    streamBuffers.qdot.resize(AMOR_NUM_JOINTS);
+    streamBuffers.x.resize(6);
+    streamBuffers.xdot.resize(6);
+
+    int posePeriodMs = config.check("posePeriodMs", yarp::os::Value(DEFAULT_POSE_PERIOD_MS),
+            "period of the pose tracking loop (milliseconds, 0 to send point-to-point moves instead)").asInt32();
+
+    if (posePeriodMs < 0)
+    {
+        yCError(ACC) << "Illegal pose tracking period:" << posePeriodMs;
+        return false;
+    }
+
+    if (posePeriodMs > 0)
+    {
+        posePeriod = posePeriodMs / 1000.0;
+
+        trackBuffers.q.resize(AMOR_NUM_JOINTS);
+        trackBuffers.qdot.resize(AMOR_NUM_JOINTS);
+        trackBuffers.x.resize(6);
+        trackBuffers.xdot.resize(6);
+
+        poseTracker = std::make_unique<ControlLoop>(posePeriod, 6, [this](const auto & xd) { return trackPose(xd); });
+
+        if (!poseTracker->start())
+        {
+            yCError(ACC) << "Unable to start pose tracking thread";
+            poseTracker.reset();
+            return false;
+        }
+    }
+
+    int forcePeriodMs = config.check("forcePeriodMs", yarp::os::Value(DEFAULT_FORCE_PERIOD_MS),
+            "period of the gravity compensation and force control loop (milliseconds)").asInt32();
+
+    // AMOR does not report motor torque constants, force control is unavailable without them
+    if (config.check("torqueConstants", "motor torque constants, one per joint (newton-meters per ampere), enable gcmp, forc and wrench"))
+    {
+        const auto * vTorqueConstants = config.find("torqueConstants").asList();
+
+        if (!vTorqueConstants || vTorqueConstants->size() != AMOR_NUM_JOINTS || forcePeriodMs <= 0)
+        {
+            yCError(ACC) << "Illegal force control parameters, expected" << AMOR_NUM_JOINTS << "torque constants and a positive period";
+            return false;
+        }
+
+        torqueConstants.resize(AMOR_NUM_JOINTS);
+
+        for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+        {
+            torqueConstants[i] = vTorqueConstants->get(i).asFloat64();
+
+            if (torqueConstants[i] <= 0.0)
+            {
+                yCError(ACC) << "Illegal torque constant for joint" << i << "(must be positive):" << torqueConstants[i];
+                return false;
+            }
+        }
+
+        forceBuffers.q.resize(AMOR_NUM_JOINTS);
+        forceBuffers.qdot.resize(AMOR_NUM_JOINTS, 0.0);
+        forceBuffers.t.resize(AMOR_NUM_JOINTS);
+
+        forceLoop = std::make_unique<ControlLoop>(forcePeriodMs / 1000.0, 6, [this](const auto & w) { return controlForce(w); });
+
+        if (!forceLoop->start())
+        {
+            yCError(ACC) << "Unable to start force control thread";
+            forceLoop.reset();
+            return false;
+        }
+    }
+
+    twistTimeout = config.check("twistTimeoutMs", yarp::os::Value(DEFAULT_TWIST_TIMEOUT_MS),
+            "stop the arm if no twist command arrives within this time (milliseconds, 0 to disable)").asInt32() / 1000.0;
+
+    movvTimeout = config.check("movvTimeoutMs", yarp::os::Value(DEFAULT_MOVV_TIMEOUT_MS),
+            "stop the arm if no movv command arrives within this time (milliseconds, 0 to disable)").asInt32() / 1000.0;
+
+    wrenchTimeout = config.check("wrenchTimeoutMs", yarp::os::Value(DEFAULT_WRENCH_TIMEOUT_MS),
+            "stop the arm if no wrench command arrives within this time (milliseconds, 0 to disable)").asInt32() / 1000.0;
+
+    if (twistTimeout > 0.0 || movvTimeout > 0.0 || wrenchTimeout > 0.0)
+    {
+        streamWatchdog = std::make_unique<DeadmanWatchdog>([this]
+            {
+                bus->call(safetySource, "streamWatchdog", [this](AMOR_HANDLE handle)
+                    {
+                        // nothing to do if superseded by any other command, including a stop
+                        if (*commandCounter != streamEpoch)
+                        {
+                            return AMOR_SUCCESS;
+                        }
+
+                        yCWarning(ACC) << "Streaming client fell silent, stopping";
+                        return notifyMotion(amor_controlled_stop(handle));
+                    });
+            });
+
+        if (!streamWatchdog->start())
+        {
+            yCError(ACC) << "Unable to start streaming watchdog thread";
+            streamWatchdog.reset();
+            return false;
+        }
+    }
+
+    motionMonitor = std::make_unique<MotionStatusMonitor>([this](bool & finished)
+        {
+            amor_movement_status status;
+
+            if (bus->call(monitorSource, "wait", [&status](AMOR_HANDLE handle) { return amor_get_movement_status(handle, &status); }) != AMOR_SUCCESS)
+            {
+                yCError(ACC) << "amor_get_movement_status() failed:" << AmorBus::lastError();
+                return false;
+            }
+
+            finished = status == AMOR_MOVEMENT_STATUS_FINISHED;
+            return true;
+        });
+
+    motionMonitor->setPeriods(waitPeriodMs / 1000.0, waitFinePeriodMs / 1000.0);
+
+    if (!motionMonitor->start())
+    {
+        yCError(ACC) << "Unable to start motion status thread";
+        motionMonitor.reset();
+        return false;
+    }
+
     currentState = VOCAB_CC_NOT_CONTROLLING;
     return true;
 }
@@ -138,21 +389,49 @@ bool AmorCartesianControl::open(yarp::os::Searchable& config)
 
 bool AmorCartesianControl::close()
 {
-    if (handle != AMOR_INVALID_HANDLE)
+    if (poseTracker)
     {
-        std::unique_lock lock(*handleMutex);
-        amor_emergency_stop(handle);
+        poseTracker->stop();
+        poseTracker.reset();
+    }
+
+    if (forceLoop)
+    {
+        forceLoop->stop();
+        forceLoop.reset();
+    }
 
-        if (ownsHandle)
+    if (streamWatchdog)
+    {
+        streamWatchdog->stop();
+        streamWatchdog.reset();
+    }
+
+    if (motionMonitor)
+    {
+        motionMonitor->stop();
+        motionMonitor.reset();
+    }
+
+    if (bus)
+    {
+        bus->call(safetySource, __func__, [](AMOR_HANDLE handle) { return amor_emergency_stop(handle); });
+
+        if (ownBus)
         {
-            amor_release(handle);
-            lock.unlock();
-            delete handleMutex;
+            ownBus->stop();
+            ownBus.reset();
         }
     }
 
+    if (ownsHandle && handle != AMOR_INVALID_HANDLE)
+    {
+        amor_release(handle);
+    }
+
     handle = AMOR_INVALID_HANDLE;
-    handleMutex = nullptr;
+    bus = nullptr;
+    commandCounter = nullptr;
 
     return cartesianDevice.close();
 }
@@ -16,13 +16,16 @@ using namespace roboticslab;
 bool AmorCartesianControl::stat(std::vector<double> & x, int * state, double * timestamp)
 {
     AMOR_VECTOR7 positions;
+    double start, end;
 
-    if (std::lock_guard lock(*handleMutex); amor_get_cartesian_position(handle, positions) != AMOR_SUCCESS)
+    if (bus->read(monitorSource, __func__, AmorBus::read_kind::CARTESIAN_POSITION, positions, &start, &end) != AMOR_SUCCESS)
     {
-        yCError(ACC) << "amor_get_cartesian_position() failed:" << amor_error();
+        yCError(ACC) << "amor_get_cartesian_position() failed:" << AmorBus::lastError();
         return false;
     }
 
+    statLatency = end - start;
+
     x.resize(6);
 
     x[0] = positions[0] * 0.001; // [m]
@@ -42,7 +45,7 @@ bool AmorCartesianControl::stat(std::vector<double> & x, int * state, double * t
 
     if (timestamp)
     {
-        *timestamp = yarp::os::Time::now();
+        *timestamp = (start + end) / 2.0; // midpoint of the acquisition window
     }
 
     return true;
@@ -52,22 +55,59 @@ bool AmorCartesianControl::stat(std::vector<double> & x, int * state, double * t
 
 bool AmorCartesianControl::inv(const std::vector<double> &xd, std::vector<double> &q)
 {
-    AMOR_VECTOR7 positions;
+    std::vector<double> qGuess(AMOR_NUM_JOINTS);
+    return solveIk(xd, qGuess, q);
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorCartesianControl::solveIk(const std::vector<double> & xd, std::vector<double> & qGuess, std::vector<double> & q)
+{
+    const double start = yarp::os::Time::now();
 
-    if (std::lock_guard lock(*handleMutex); amor_get_actual_positions(handle, &positions) != AMOR_SUCCESS)
+    // targets relative to the TCP change meaning as the arm moves, never cache them
+    const bool cacheable = ikCache.isEnabled() && referenceFrame == ICartesianSolver::BASE_FRAME;
+    auto seed = IkSeedCache::match::NONE;
+    unsigned int attempts = 0;
+    bool ok = false;
+
+    if (cacheable)
     {
-        yCError(ACC) << "amor_get_actual_positions() failed:" << amor_error();
-        return false;
+        seed = ikCache.find(xd, qGuess);
+    }
+
+    if (seed == IkSeedCache::match::EXACT)
+    {
+        q = qGuess;
+        ok = true;
+    }
+    else if (seed == IkSeedCache::match::NEAR)
+    {
+        attempts++;
+        ok = iCartesianSolver->invKin(xd, qGuess, q, referenceFrame);
     }
 
-    std::vector<double> currentQ(AMOR_NUM_JOINTS);
+    if (!ok)
+    {
+        // cold start from the measured joint state, also if the warm start did not converge
+        if (!readJoints(monitorSource, qGuess))
+        {
+            ikCache.account(seed, attempts, false, yarp::os::Time::now() - start);
+            return false;
+        }
 
-    for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+        attempts++;
+        ok = iCartesianSolver->invKin(xd, qGuess, q, referenceFrame);
+    }
+
+    if (ok && cacheable && seed != IkSeedCache::match::EXACT)
     {
-        currentQ[i] = KinRepresentation::radToDeg(positions[i]);
+        ikCache.store(xd, q);
     }
 
-    if (!iCartesianSolver->invKin(xd, currentQ, q, referenceFrame))
+    ikCache.account(seed, attempts, ok, yarp::os::Time::now() - start);
+
+    if (!ok)
     {
         yCError(ACC) << "invKin() failed";
         return false;
@@ -80,30 +120,19 @@ bool AmorCartesianControl::inv(const std::vector<double> &xd, std::vector<double
 
 bool AmorCartesianControl::movj(const std::vector<double> &xd)
 {
-    std::vector<double> qd;
+    std::vector<double> qGuess(AMOR_NUM_JOINTS), qd;
 
-    if (!inv(xd, qd))
+    if (!solveIk(xd, qGuess, qd))
     {
         yCError(ACC) << "inv() failed";
         return false;
     }
 
-    AMOR_VECTOR7 positions;
-
-    for (int i = 0; i < qd.size(); i++)
-    {
-        positions[i] = KinRepresentation::degToRad(qd[i]);
-    }
+    // only used to tell wait() when to expect the end of the motion, hence the joints are not
+    // read again: a cached seed lies near the target, which at worst makes wait() poll early
+    const double duration = predictDuration(qGuess, qd);
 
-    if (std::lock_guard lock(*handleMutex); amor_set_positions(handle, positions) != AMOR_SUCCESS)
-    {
-        yCError(ACC) << "amor_set_positions() failed:" << amor_error();
-        return false;
-    }
-
-    currentState = VOCAB_CC_MOVJ_CONTROLLING;
-
-    return true;
+    return moveJoints(__func__, qd, duration);
 }
 
 // -----------------------------------------------------------------------------
@@ -141,9 +170,9 @@ bool AmorCartesianControl::movl(const std::vector<double> &xd)
     {
         AMOR_VECTOR7 positions;
 
-        if (std::lock_guard lock(*handleMutex); amor_get_actual_positions(handle, &positions) != AMOR_SUCCESS)
+        if (bus->call(commandSource, __func__, [&](AMOR_HANDLE handle) { return amor_get_actual_positions(handle, &positions); }) != AMOR_SUCCESS)
         {
-            yCError(ACC) << "amor_get_actual_positions() failed:" << amor_error();
+            yCError(ACC) << "amor_get_actual_positions() failed:" << AmorBus::lastError();
             return false;
         }
 
@@ -187,9 +216,22 @@ bool AmorCartesianControl::movl(const std::vector<double> &xd)
     positions[4] = xd_rpy[4];
     positions[5] = xd_rpy[5];
 
-    if (std::lock_guard lock(*handleMutex); amor_set_cartesian_positions(handle, positions) != AMOR_SUCCESS)
+    auto res = bus->call(commandSource, __func__, [&](AMOR_HANDLE handle)
+        {
+            auto res = notifyMotion(amor_set_cartesian_positions(handle, positions));
+
+            // duration unknown, the monitor assumes that of previous linear motions
+            if (res == AMOR_SUCCESS)
+            {
+                motionMonitor->expect(0.0);
+            }
+
+            return res;
+        });
+
+    if (res != AMOR_SUCCESS)
     {
-        yCError(ACC) << "amor_set_cartesian_positions() failed:" << amor_error();
+        yCError(ACC) << "amor_set_cartesian_positions() failed:" << AmorBus::lastError();
         return false;
     }
 
@@ -208,7 +250,9 @@ bool AmorCartesianControl::movv(const std::vector<double> &xdotd)
         return false;
     }
 
-    std::vector<double> xCurrent;
+    std::lock_guard lock(streamMutex);
+    auto & xCurrent = streamBuffers.x;
+    auto & xdotd_rpy = streamBuffers.xdot;
 
     if (!stat(xCurrent))
     {
@@ -216,11 +260,9 @@ bool AmorCartesianControl::movv(const std::vector<double> &xdotd)
         return false;
     }
 
-    std::vector<double> xdotd_rpy;
-
     KinRepresentation::decodeVelocity(xCurrent, xdotd, xdotd_rpy, KinRepresentation::coordinate_system::CARTESIAN, KinRepresentation::orientation_system::RPY);
 
-    AMOR_VECTOR7 velocities;
+    AMOR_VECTOR7 velocities {};
 
     velocities[0] = xdotd_rpy[0] * 1000; // [mm/s]
     velocities[1] = xdotd_rpy[1] * 1000;
@@ -231,12 +273,13 @@ bool AmorCartesianControl::movv(const std::vector<double> &xdotd)
     velocities[4] = -xdotd_rpy[5];
     velocities[5] = xdotd_rpy[3];
 
-    if (std::lock_guard lock(*handleMutex); amor_set_cartesian_velocities(handle, velocities) != AMOR_SUCCESS)
+    if (bus->call(streamSource, __func__, [&](AMOR_HANDLE handle) { return sendStreamed(movvFilter, amor_set_cartesian_velocities, handle, velocities); }) != AMOR_SUCCESS)
     {
-        yCError(ACC) << "amor_set_cartesian_velocities() failed:" << amor_error();
+        yCError(ACC) << "amor_set_cartesian_velocities() failed:" << AmorBus::lastError();
         return false;
     }
 
+    feedWatchdog(movvTimeout);
     currentState = VOCAB_CC_MOVV_CONTROLLING;
 
     return true;
@@ -246,16 +289,41 @@ bool AmorCartesianControl::movv(const std::vector<double> &xdotd)
 
 bool AmorCartesianControl::gcmp()
 {
-    yCWarning(ACC) << "gcmp() not implemented";
-    return false;
+    if (!forceLoop)
+    {
+        yCError(ACC) << "gcmp() not available, torque constants not configured (torqueConstants)";
+        return false;
+    }
+
+    const std::vector<double> noWrench(6, 0.0);
+    armLoop(*forceLoop, noWrench);
+    feedWatchdog(0.0); // not streamed, a pending twist or wrench watchdog must not stop us
+    currentState = VOCAB_CC_GCMP_CONTROLLING;
+
+    return true;
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorCartesianControl::forc(const std::vector<double> &fd)
 {
-    yCWarning(ACC) << "forc() not implemented";
-    return false;
+    if (!forceLoop)
+    {
+        yCError(ACC) << "forc() not available, torque constants not configured (torqueConstants)";
+        return false;
+    }
+
+    if (fd.size() != 6)
+    {
+        yCError(ACC) << "Illegal wrench size:" << fd.size() << "(expected 6)";
+        return false;
+    }
+
+    armLoop(*forceLoop, fd);
+    feedWatchdog(0.0); // not streamed, a pending twist or wrench watchdog must not stop us
+    currentState = VOCAB_CC_FORC_CONTROLLING;
+
+    return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -263,10 +331,19 @@ bool AmorCartesianControl::forc(const std::vector<double> &fd)
 bool AmorCartesianControl::stopControl()
 {
     currentState = VOCAB_CC_NOT_CONTROLLING;
+    feedWatchdog(0.0);
 
-    if (std::lock_guard lock(*handleMutex); amor_controlled_stop(handle) != AMOR_SUCCESS)
+    for (auto * loop : {poseTracker.get(), forceLoop.get()})
     {
-        yCError(ACC) << "amor_controlled_stop() failed:" << amor_error();
+        if (loop)
+        {
+            loop->disarm();
+        }
+    }
+
+    if (bus->call(safetySource, __func__, [&](AMOR_HANDLE handle) { return notifyMotion(amor_controlled_stop(handle)); }) != AMOR_SUCCESS)
+    {
+        yCError(ACC) << "amor_controlled_stop() failed:" << AmorBus::lastError();
         return false;
     }
 
@@ -282,38 +359,18 @@ bool AmorCartesianControl::wait(double timeout)
         return true;
     }
 
-    AMOR_RESULT res = AMOR_SUCCESS;
-    amor_movement_status status;
-
-    double start = yarp::os::Time::now();
+    // all waiters share the same status polls, and are woken as soon as the motion ends
+    auto outcome = motionMonitor->wait(timeout);
 
-    do
+    if (outcome == MotionStatusMonitor::outcome::TIMEOUT)
     {
-        if (timeout != 0.0 && yarp::os::Time::now() - start > timeout)
-        {
-            yCWarning(ACC, "Timeout reached (%f seconds), stopping control", timeout);
-            stopControl();
-            break;
-        }
-
-        {
-            std::lock_guard lock(*handleMutex);
-            res = amor_get_movement_status(handle, &status);
-        }
-
-        if (res == AMOR_FAILED)
-        {
-            yCError(ACC) << "amor_get_movement_status() failed:" << amor_error();
-            break;
-        }
-
-        yarp::os::Time::delay(waitPeriodMs / 1000.0);
+        yCWarning(ACC, "Timeout reached (%f seconds), stopping control", timeout);
+        stopControl();
     }
-    while (status != AMOR_MOVEMENT_STATUS_FINISHED);
 
     currentState = VOCAB_CC_NOT_CONTROLLING;
 
-    return res == AMOR_SUCCESS;
+    return outcome != MotionStatusMonitor::outcome::FAILED;
 }
 
 // -----------------------------------------------------------------------------
@@ -346,9 +403,9 @@ bool AmorCartesianControl::act(int command)
         return false;
     }
 
-    if (std::lock_guard lock(*handleMutex); amor_command(handle) != AMOR_SUCCESS)
+    if (bus->call(commandSource, __func__, [&](AMOR_HANDLE handle) { return amor_command(handle); }) != AMOR_SUCCESS)
     {
-        yCError(ACC) << "amor_command() failed:" << amor_error();
+        yCError(ACC) << "amor_command() failed:" << AmorBus::lastError();
         return false;
     }
 
@@ -359,27 +416,41 @@ bool AmorCartesianControl::act(int command)
 
 void AmorCartesianControl::pose(const std::vector<double> &x)
 {
-    yCWarning(ACC) << "pose() not supported, falling back to movj()";
-    movj(x);
-}
+    if (poseTracker)
+    {
+        if (referenceFrame == ICartesianSolver::TCP_FRAME)
+        {
+            yCWarning(ACC) << "TCP frame not supported yet in pose command";
+            return;
+        }
 
-// -----------------------------------------------------------------------------
+        armLoop(*poseTracker, x);
+        feedWatchdog(0.0); // take over from a previous twist or wrench
+        return;
+    }
 
-void AmorCartesianControl::twist(const std::vector<double> &xdot)
-{
-    AMOR_VECTOR7 positions;
+    // same as movj(), minus the allocations
+    std::lock_guard lock(streamMutex);
 
-    if (std::lock_guard lock(*handleMutex); amor_get_actual_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!solveIk(x, streamBuffers.qGuess, streamBuffers.q))
     {
-        yCError(ACC) << "amor_get_actual_positions() failed:" << amor_error();
         return;
     }
 
-    std::vector<double> currentQ(AMOR_NUM_JOINTS), qdot;
+    moveJoints(__func__, streamBuffers.q);
+}
+
+// -----------------------------------------------------------------------------
 
-    for (int i = 0; i < AMOR_NUM_JOINTS; i++)
+void AmorCartesianControl::twist(const std::vector<double> &xdot)
+{
+    std::lock_guard lock(streamMutex);
+    auto & currentQ = streamBuffers.q;
+    auto & qdot = streamBuffers.qdot;
+
+    if (!readJoints(streamSource, currentQ))
     {
-        currentQ[i] = KinRepresentation::radToDeg(positions[i]);
+        return;
     }
 
     if (!iCartesianSolver->diffInvKin(currentQ, xdot, qdot, referenceFrame))
@@ -390,8 +461,7 @@ void AmorCartesianControl::twist(const std::vector<double> &xdot)
 
     if (!checkJointVelocities(qdot))
     {
-        std::lock_guard lock(*handleMutex);
-        amor_controlled_stop(handle);
+        bus->call(safetySource, __func__, [this](AMOR_HANDLE handle) { return notifyMotion(amor_controlled_stop(handle)); });
         return;
     }
 
@@ -402,18 +472,33 @@ void AmorCartesianControl::twist(const std::vector<double> &xdot)
         velocities[i] = KinRepresentation::degToRad(qdot[i]);
     }
 
-    if (std::lock_guard lock(*handleMutex); amor_set_velocities(handle, velocities) != AMOR_SUCCESS)
+    if (bus->call(streamSource, __func__, [&](AMOR_HANDLE handle) { return sendStreamed(twistFilter, amor_set_velocities, handle, velocities); }) != AMOR_SUCCESS)
     {
-        yCError(ACC) << "amor_set_velocities() failed:" << amor_error();
+        yCError(ACC) << "amor_set_velocities() failed:" << AmorBus::lastError();
         return;
     }
+
+    feedWatchdog(twistTimeout);
 }
 
 // -----------------------------------------------------------------------------
 
 void AmorCartesianControl::wrench(const std::vector<double> &w)
 {
-    yCWarning(ACC) << "wrench() not supported";
+    if (!forceLoop)
+    {
+        yCError(ACC) << "wrench() not available, torque constants not configured (torqueConstants)";
+        return;
+    }
+
+    if (w.size() != 6)
+    {
+        yCError(ACC) << "Illegal wrench size:" << w.size() << "(expected 6)";
+        return;
+    }
+
+    armLoop(*forceLoop, w);
+    feedWatchdog(wrenchTimeout);
 }
 
 // -----------------------------------------------------------------------------
@@ -429,9 +514,9 @@ bool AmorCartesianControl::setParameter(int vocab, double value)
     switch (vocab)
     {
     case VOCAB_CC_CONFIG_GAIN:
-        if (value < 0.0)
+        if (value <= 0.0 || value > 1.0)
         {
-            yCError(ACC) << "Controller gain cannot be negative";
+            yCError(ACC) << "Illegal controller gain:" << value << "(must be in range (0, 1])";
             return false;
         }
         gain = value;
@@ -443,6 +528,7 @@ bool AmorCartesianControl::setParameter(int vocab, double value)
             return false;
         }
         waitPeriodMs = value;
+        motionMonitor->setPeriods(waitPeriodMs / 1000.0, waitFinePeriodMs / 1000.0);
         break;
     case VOCAB_CC_CONFIG_FRAME:
         if (value != ICartesianSolver::BASE_FRAME && value != ICartesianSolver::TCP_FRAME)
@@ -475,6 +561,48 @@ bool AmorCartesianControl::getParameter(int vocab, double * value)
     case VOCAB_CC_CONFIG_FRAME:
         *value = referenceFrame;
         break;
+    case VOCAB_ACC_STAT_LATENCY:
+        *value = statLatency;
+        break;
+    case VOCAB_ACC_SENT_FRAMES:
+        *value = twistFilter.getSent() + movvFilter.getSent() + poseFilter.getSent() + forceFilter.getSent();
+        break;
+    case VOCAB_ACC_SUPPRESSED_FRAMES:
+        *value = twistFilter.getSuppressed() + movvFilter.getSuppressed() + poseFilter.getSuppressed() + forceFilter.getSuppressed();
+        break;
+    case VOCAB_ACC_IK_CALLS:
+        *value = ikCache.getStats().calls;
+        break;
+    case VOCAB_ACC_IK_CACHE_HITS:
+        *value = ikCache.getStats().hits;
+        break;
+    case VOCAB_ACC_IK_WARM_STARTS:
+        *value = ikCache.getStats().warmStarts;
+        break;
+    case VOCAB_ACC_IK_ATTEMPTS:
+        *value = ikCache.getStats().attempts;
+        break;
+    case VOCAB_ACC_IK_LAST_TIME:
+        *value = ikCache.getStats().lastTime;
+        break;
+    case VOCAB_ACC_IK_MEAN_TIME:
+        *value = ikCache.getStats().meanTime;
+        break;
+    case VOCAB_ACC_IK_MAX_TIME:
+        *value = ikCache.getStats().maxTime;
+        break;
+    case VOCAB_ACC_FORCE_LOOP_CYCLES:
+        *value = forceLoop ? forceLoop->getStats().cycles : 0;
+        break;
+    case VOCAB_ACC_FORCE_LOOP_OVERRUNS:
+        *value = forceLoop ? forceLoop->getStats().overruns : 0;
+        break;
+    case VOCAB_ACC_FORCE_LOOP_MEAN_JITTER:
+        *value = forceLoop ? forceLoop->getStats().meanJitter : 0.0;
+        break;
+    case VOCAB_ACC_FORCE_LOOP_MAX_JITTER:
+        *value = forceLoop ? forceLoop->getStats().maxJitter : 0.0;
+        break;
     default:
         yCError(ACC) << "Unrecognized or unsupported config parameter key:" << yarp::os::Vocab32::decode(vocab);
         return false;
@@ -510,6 +638,24 @@ bool AmorCartesianControl::getParameters(std::map<int, double> & params)
     params.emplace(VOCAB_CC_CONFIG_GAIN, gain);
     params.emplace(VOCAB_CC_CONFIG_WAIT_PERIOD, waitPeriodMs);
     params.emplace(VOCAB_CC_CONFIG_FRAME, referenceFrame);
+    params.emplace(VOCAB_ACC_STAT_LATENCY, statLatency);
+    params.emplace(VOCAB_ACC_SENT_FRAMES, twistFilter.getSent() + movvFilter.getSent() + poseFilter.getSent() + forceFilter.getSent());
+    params.emplace(VOCAB_ACC_SUPPRESSED_FRAMES, twistFilter.getSuppressed() + movvFilter.getSuppressed() + poseFilter.getSuppressed() + forceFilter.getSuppressed());
+
+    const auto ikStats = ikCache.getStats();
+    params.emplace(VOCAB_ACC_IK_CALLS, ikStats.calls);
+    params.emplace(VOCAB_ACC_IK_CACHE_HITS, ikStats.hits);
+    params.emplace(VOCAB_ACC_IK_WARM_STARTS, ikStats.warmStarts);
+    params.emplace(VOCAB_ACC_IK_ATTEMPTS, ikStats.attempts);
+    params.emplace(VOCAB_ACC_IK_LAST_TIME, ikStats.lastTime);
+    params.emplace(VOCAB_ACC_IK_MEAN_TIME, ikStats.meanTime);
+    params.emplace(VOCAB_ACC_IK_MAX_TIME, ikStats.maxTime);
+
+    const auto loopStats = forceLoop ? forceLoop->getStats() : ControlLoop::Stats {};
+    params.emplace(VOCAB_ACC_FORCE_LOOP_CYCLES, loopStats.cycles);
+    params.emplace(VOCAB_ACC_FORCE_LOOP_OVERRUNS, loopStats.overruns);
+    params.emplace(VOCAB_ACC_FORCE_LOOP_MEAN_JITTER, loopStats.meanJitter);
+    params.emplace(VOCAB_ACC_FORCE_LOOP_MAX_JITTER, loopStats.maxJitter);
     return true;
 }
 
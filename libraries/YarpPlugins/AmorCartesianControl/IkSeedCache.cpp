@@ -0,0 +1,136 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "IkSeedCache.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+void IkSeedCache::configure(std::size_t capacity, double radius)
+{
+    std::lock_guard lock(mutex);
+    this->capacity = capacity;
+    this->radius = radius;
+    entries.clear();
+    entries.reserve(capacity);
+}
+
+// -----------------------------------------------------------------------------
+
+IkSeedCache::match IkSeedCache::find(const std::vector<double> & x, std::vector<double> & q)
+{
+    std::lock_guard lock(mutex);
+
+    double best = std::numeric_limits<double>::infinity();
+    std::size_t nearest = entries.size();
+
+    for (std::size_t i = 0; i < entries.size(); i++)
+    {
+        if (double d = distance(entries[i].x, x); d < best)
+        {
+            best = d;
+            nearest = i;
+        }
+    }
+
+    if (nearest == entries.size() || best > radius)
+    {
+        return match::NONE;
+    }
+
+    touch(nearest);
+    q = entries.front().q;
+
+    return best <= EXACT_TOLERANCE ? match::EXACT : match::NEAR;
+}
+
+// -----------------------------------------------------------------------------
+
+void IkSeedCache::store(const std::vector<double> & x, const std::vector<double> & q)
+{
+    std::lock_guard lock(mutex);
+
+    if (capacity == 0)
+    {
+        return;
+    }
+
+    if (entries.size() < capacity)
+    {
+        entries.emplace_back();
+    }
+
+    // recycle the least recently used entry, keeping its storage
+    touch(entries.size() - 1);
+    entries.front().x = x;
+    entries.front().q = q;
+}
+
+// -----------------------------------------------------------------------------
+
+void IkSeedCache::account(match seed, unsigned int attempts, bool ok, double elapsed)
+{
+    std::lock_guard lock(mutex);
+
+    stats.calls++;
+    stats.attempts += attempts;
+
+    if (!ok)
+    {
+        stats.failures++;
+    }
+    else if (seed == match::EXACT)
+    {
+        stats.hits++;
+    }
+    else if (seed == match::NEAR && attempts == 1)
+    {
+        stats.warmStarts++;
+    }
+
+    stats.lastTime = elapsed;
+    stats.maxTime = std::max(stats.maxTime, elapsed);
+    totalTime += elapsed;
+    stats.meanTime = totalTime / stats.calls;
+}
+
+// -----------------------------------------------------------------------------
+
+IkSeedCache::Stats IkSeedCache::getStats() const
+{
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+// -----------------------------------------------------------------------------
+
+double IkSeedCache::distance(const std::vector<double> & lhs, const std::vector<double> & rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double sum = 0.0;
+
+    for (std::size_t i = 0; i < lhs.size(); i++)
+    {
+        sum += (lhs[i] - rhs[i]) * (lhs[i] - rhs[i]);
+    }
+
+    return std::sqrt(sum);
+}
+
+// -----------------------------------------------------------------------------
+
+void IkSeedCache::touch(std::size_t i)
+{
+    std::rotate(entries.begin(), entries.begin() + i, entries.begin() + i + 1);
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,94 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_IK_SEED_CACHE_HPP__
+#define __AMOR_IK_SEED_CACHE_HPP__
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Remembers recent inverse kinematics solutions to warm-start the solver.
+ *
+ * Keeps a small least-recently-used list of pose-to-solution pairs, the most
+ * recent one being the last solution found. A query either matches a stored
+ * pose exactly, in which case its solution may be reused as is, or is close
+ * enough to one of them to use its solution as initial guess; otherwise the
+ * caller should seed the solver with the measured joint state. Poses are
+ * compared element-wise, with linear and angular coordinates weighted alike.
+ * Entries are recycled once the list is full, hence no allocations take place
+ * after warm-up. All methods are thread-safe.
+ */
+class IkSeedCache
+{
+public:
+    enum class match { NONE, NEAR, EXACT };
+
+    //! Per-call statistics, times in seconds.
+    struct Stats
+    {
+        unsigned long calls;
+        unsigned long hits; //!< solved from an exact match, without running the solver
+        unsigned long warmStarts; //!< solved from a nearby stored solution
+        unsigned long attempts; //!< solver runs, including retries from the measured joint state
+        unsigned long failures;
+        double lastTime;
+        double meanTime;
+        double maxTime;
+    };
+
+    /**
+     * @param capacity maximum number of stored solutions, zero disables the cache.
+     * @param radius maximum distance between poses for a stored solution to be used as seed.
+     */
+    void configure(std::size_t capacity, double radius);
+
+    bool isEnabled() const
+    { return capacity != 0; }
+
+    /**
+     * Look for the stored solution of the nearest pose within the configured radius.
+     * @param x target pose.
+     * @param q stored solution, untouched if no match was found.
+     * @return kind of match.
+     */
+    match find(const std::vector<double> & x, std::vector<double> & q);
+
+    //! Store a new solution, evicting the least recently used one if full.
+    void store(const std::vector<double> & x, const std::vector<double> & q);
+
+    //! Account for a call to the inverse kinematics solver.
+    void account(match seed, unsigned int attempts, bool ok, double elapsed);
+
+    Stats getStats() const;
+
+private:
+    static constexpr double EXACT_TOLERANCE = 1e-9;
+
+    struct Entry
+    {
+        std::vector<double> x;
+        std::vector<double> q;
+    };
+
+    static double distance(const std::vector<double> & lhs, const std::vector<double> & rhs);
+
+    //! Move an entry to the front of the list.
+    void touch(std::size_t i);
+
+    mutable std::mutex mutex;
+    std::vector<Entry> entries; // most recently used first
+    std::size_t capacity {0};
+    double radius {0.0};
+
+    Stats stats {};
+    double totalTime {0.0};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_IK_SEED_CACHE_HPP__
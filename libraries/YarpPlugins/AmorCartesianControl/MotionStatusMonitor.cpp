@@ -0,0 +1,228 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "MotionStatusMonitor.hpp"
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+namespace
+{
+    // weight of the last observed duration in the smoothed estimates
+    constexpr auto LEARNING_RATE = 0.25;
+}
+
+// -----------------------------------------------------------------------------
+
+bool MotionStatusMonitor::start()
+{
+    if (worker.joinable())
+    {
+        return false;
+    }
+
+    stopping = false;
+    worker = std::thread(&MotionStatusMonitor::run, this);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void MotionStatusMonitor::stop()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+
+    schedule.notify_one();
+    completion.notify_all();
+
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void MotionStatusMonitor::setPeriods(double coarse, double fine)
+{
+    {
+        std::lock_guard lock(mutex);
+        coarsePeriod = seconds(coarse);
+        finePeriod = seconds(std::min(fine, coarse));
+    }
+
+    schedule.notify_one();
+}
+
+// -----------------------------------------------------------------------------
+
+void MotionStatusMonitor::expect(double duration)
+{
+    {
+        std::lock_guard lock(mutex);
+
+        generation++;
+        finished = false;
+        motionStart = clock::now();
+        lastPoll = clock::time_point::min(); // poll at once if anyone is waiting
+        latePolls = 0;
+        predicted = duration;
+
+        if (duration > 0.0)
+        {
+            expectedEnd = seconds(duration * scale);
+        }
+        else
+        {
+            expectedEnd = seconds(unpredictedDuration);
+        }
+    }
+
+    schedule.notify_one();
+}
+
+// -----------------------------------------------------------------------------
+
+MotionStatusMonitor::outcome MotionStatusMonitor::wait(double timeout)
+{
+    std::unique_lock lock(mutex);
+
+    const auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(seconds(timeout));
+    const auto failuresBefore = failures;
+
+    // a new motion commanded in the meantime is waited for as well
+    const auto done = [this, failuresBefore] { return finished || failures != failuresBefore || stopping; };
+
+    if (!done())
+    {
+        waiters++;
+        schedule.notify_one();
+
+        if (timeout == 0.0)
+        {
+            completion.wait(lock, done);
+        }
+        else
+        {
+            completion.wait_until(lock, deadline, done);
+        }
+
+        waiters--;
+    }
+
+    if (finished)
+    {
+        return outcome::FINISHED;
+    }
+
+    return failures != failuresBefore || stopping ? outcome::FAILED : outcome::TIMEOUT;
+}
+
+// -----------------------------------------------------------------------------
+
+MotionStatusMonitor::clock::time_point MotionStatusMonitor::nextPoll() const
+{
+    if (lastPoll == clock::time_point::min())
+    {
+        return clock::now();
+    }
+
+    if (expectedEnd == seconds::zero())
+    {
+        return lastPoll + std::chrono::duration_cast<clock::duration>(coarsePeriod);
+    }
+
+    const auto end = motionStart + std::chrono::duration_cast<clock::duration>(expectedEnd);
+    const auto coarse = lastPoll + std::chrono::duration_cast<clock::duration>(coarsePeriod);
+
+    // far from the end, but don't sleep past it
+    if (coarse < end)
+    {
+        return std::max(std::min(coarse, end - std::chrono::duration_cast<clock::duration>(finePeriod)), lastPoll);
+    }
+
+    // near or past the end, back off exponentially if it takes longer than expected
+    const auto period = std::min(coarsePeriod, finePeriod * static_cast<double>(1U << std::min(latePolls, 16U)));
+    return lastPoll + std::chrono::duration_cast<clock::duration>(period);
+}
+
+// -----------------------------------------------------------------------------
+
+void MotionStatusMonitor::learn(clock::time_point now)
+{
+    const double observed = seconds(now - motionStart).count();
+
+    if (predicted > 0.0)
+    {
+        scale += LEARNING_RATE * (observed / predicted - scale);
+    }
+    else if (unpredictedDuration == 0.0)
+    {
+        unpredictedDuration = observed;
+    }
+    else
+    {
+        unpredictedDuration += LEARNING_RATE * (observed - unpredictedDuration);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void MotionStatusMonitor::run()
+{
+    std::unique_lock lock(mutex);
+
+    while (!stopping)
+    {
+        if (waiters == 0 || finished)
+        {
+            schedule.wait(lock);
+            continue;
+        }
+
+        if (const auto due = nextPoll(); clock::now() < due)
+        {
+            // woken early by a new motion, waiter or period change
+            schedule.wait_until(lock, due);
+            continue;
+        }
+
+        const auto current = generation;
+        bool isFinished = false;
+
+        lock.unlock();
+        const bool ok = poll(isFinished);
+        lock.lock();
+
+        // stale if a new motion was commanded while polling
+        if (current != generation)
+        {
+            continue;
+        }
+
+        const auto now = clock::now();
+        lastPoll = now;
+
+        if (expectedEnd != seconds::zero() && now >= motionStart + std::chrono::duration_cast<clock::duration>(expectedEnd))
+        {
+            latePolls++;
+        }
+
+        if (!ok)
+        {
+            failures++;
+            completion.notify_all();
+        }
+        else if (isFinished)
+        {
+            finished = true;
+            learn(now);
+            completion.notify_all();
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
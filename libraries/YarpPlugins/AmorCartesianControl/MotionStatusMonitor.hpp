@@ -0,0 +1,108 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_MOTION_STATUS_MONITOR_HPP__
+#define __AMOR_MOTION_STATUS_MONITOR_HPP__
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorCartesianControl
+ * @brief Polls the movement status of the arm on behalf of all waiting clients.
+ *
+ * A single thread polls while there is at least one waiter, regardless of how
+ * many of them there are, and wakes them all as soon as the motion is seen
+ * finished. Polls are spaced by the coarse period until the predicted end of
+ * the motion draws near, then by the fine period, backing off again if the
+ * motion lasts longer than expected. Predictions are corrected with the
+ * durations observed in previous motions; if none is given, the duration of
+ * previous unpredicted motions is assumed.
+ */
+class MotionStatusMonitor
+{
+public:
+    /**
+     * Query the movement status once.
+     * @param finished set to true if the arm is not moving.
+     * @return false on failure.
+     */
+    using poll_t = std::function<bool(bool & finished)>;
+
+    enum class outcome { FINISHED, TIMEOUT, FAILED };
+
+    explicit MotionStatusMonitor(poll_t poll)
+        : poll(std::move(poll))
+    {}
+
+    ~MotionStatusMonitor()
+    { stop(); }
+
+    MotionStatusMonitor(const MotionStatusMonitor &) = delete;
+    MotionStatusMonitor & operator=(const MotionStatusMonitor &) = delete;
+
+    //! Launch the polling thread.
+    bool start();
+
+    //! Join the polling thread, waiters are released as if polling failed.
+    void stop();
+
+    //! Set the coarse and fine polling periods [s].
+    void setPeriods(double coarse, double fine);
+
+    /**
+     * Register a new motion, call it right after the command was accepted.
+     * @param duration predicted duration [s], zero if unknown.
+     */
+    void expect(double duration);
+
+    //! Block until the current motion finishes, timeout in seconds (zero to wait forever).
+    outcome wait(double timeout);
+
+private:
+    using clock = std::chrono::steady_clock;
+    using seconds = std::chrono::duration<double>;
+
+    void run();
+
+    //! Time of the next poll, must hold the lock.
+    clock::time_point nextPoll() const;
+
+    //! Learn from the duration of the motion just finished, must hold the lock.
+    void learn(clock::time_point now);
+
+    const poll_t poll;
+
+    mutable std::mutex mutex;
+    std::condition_variable schedule; // wakes the polling thread
+    std::condition_variable completion; // wakes the waiters
+    std::thread worker;
+    bool stopping {false};
+
+    seconds coarsePeriod {0.03};
+    seconds finePeriod {0.002};
+
+    unsigned int waiters {0};
+    unsigned int generation {0}; // bumped on each new motion
+    unsigned int failures {0}; // bumped on each failed poll
+    bool finished {true};
+
+    clock::time_point motionStart;
+    clock::time_point lastPoll;
+    double predicted {0.0}; // [s], as given by the client
+    seconds expectedEnd {0.0}; // since the motion started, zero if unknown
+    unsigned int latePolls {0}; // fine polls issued past the expected end
+
+    double scale {1.0}; // observed over predicted duration, smoothed
+    double unpredictedDuration {0.0}; // [s], smoothed
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_MOTION_STATUS_MONITOR_HPP__
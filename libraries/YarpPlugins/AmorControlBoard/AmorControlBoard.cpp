@@ -2,10 +2,13 @@
 
 #include "AmorControlBoard.hpp"
 
+#include <algorithm>
+
 #define _USE_MATH_DEFINES
 #include <cmath>
 
 #include <yarp/os/Log.h>
+#include <yarp/os/Time.h>
 
 #include "LogComponent.hpp"
 
@@ -15,9 +18,9 @@ using namespace roboticslab;
 
 bool AmorControlBoard::indexWithinRange(const int& idx)
 {
-    if (idx >= AMOR_NUM_JOINTS)
+    if (idx < 0 || idx >= AMOR_NUM_JOINTS)
     {
-        yCError(ACB, "Index out of range: %d >= %d", idx, AMOR_NUM_JOINTS);
+        yCError(ACB, "Index out of range (< 0 or >= %d): %d", AMOR_NUM_JOINTS, idx);
         return false;
     }
 
@@ -45,6 +48,26 @@ bool AmorControlBoard::batchWithinRange(const int& n_joint)
 
 // -----------------------------------------------------------------------------
 
+bool AmorControlBoard::batchWithinRange(const int& n_joint, const int * joints)
+{
+    if (!batchWithinRange(n_joint))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < n_joint; i++)
+    {
+        if (!indexWithinRange(joints[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
 double AmorControlBoard::toDeg(double rad)
 {
     return rad * 180 / M_PI;
@@ -58,3 +81,78 @@ double AmorControlBoard::toRad(double deg)
 }
 
 // -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getActualPositions(AMOR_VECTOR7 & positions, double * timestamp)
+{
+    if (statePoller)
+    {
+        const auto sample = statePoller->getSample();
+        std::copy(sample.positions, sample.positions + AMOR_NUM_JOINTS, positions);
+
+        if (timestamp)
+        {
+            *timestamp = sample.timestamp;
+        }
+
+        return true;
+    }
+
+    double start, end;
+
+    if (bus->read(monitorSource, __func__, AmorBus::read_kind::ACTUAL_POSITIONS, positions, &start, &end) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "amor_get_actual_positions() failed: %s", AmorBus::lastError());
+        return false;
+    }
+
+    encoderLatency = end - start;
+
+    if (timestamp)
+    {
+        *timestamp = (start + end) / 2.0;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getActualVelocities(AMOR_VECTOR7 & velocities)
+{
+    if (statePoller)
+    {
+        const auto sample = statePoller->getSample();
+        std::copy(sample.velocities, sample.velocities + AMOR_NUM_JOINTS, velocities);
+        return true;
+    }
+
+    if (bus->read(monitorSource, __func__, AmorBus::read_kind::ACTUAL_VELOCITIES, velocities) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "amor_get_actual_velocities() failed: %s", AmorBus::lastError());
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getActualCurrents(AMOR_VECTOR7 & currents)
+{
+    if (statePoller)
+    {
+        const auto sample = statePoller->getSample();
+        std::copy(sample.currents, sample.currents + AMOR_NUM_JOINTS, currents);
+        return true;
+    }
+
+    if (bus->read(monitorSource, __func__, AmorBus::read_kind::ACTUAL_CURRENTS, currents) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "amor_get_actual_currents() failed: %s", AmorBus::lastError());
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
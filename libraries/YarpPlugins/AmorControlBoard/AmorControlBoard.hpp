@@ -3,7 +3,13 @@
 #ifndef __AMOR_CONTROL_BOARD_HPP__
 #define __AMOR_CONTROL_BOARD_HPP__
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <yarp/dev/ControlBoardInterfaces.h>
@@ -11,6 +17,18 @@
 
 #include <amor.h>
 
+#include "AmorBus.hpp"
+#include "BusMonitor.hpp"
+#include "CommandShadow.hpp"
+#include "CurrentStreamer.hpp"
+#include "DeadmanWatchdog.hpp"
+#include "MotionTracker.hpp"
+#include "SeqLock.hpp"
+#include "SoftLimits.hpp"
+#include "StatePoller.hpp"
+#include "StopMonitor.hpp"
+#include "TrajectoryGenerator.hpp"
+
 namespace roboticslab
 {
 
@@ -31,6 +49,8 @@ class AmorControlBoard : public yarp::dev::DeviceDriver,
                          public yarp::dev::ICurrentControl,
                          public yarp::dev::IEncodersTimed,
                          public yarp::dev::IPositionControl,
+                         public yarp::dev::IPositionDirect,
+                         public yarp::dev::IRemoteVariables,
                          public yarp::dev::IVelocityControl
 {
 public:
@@ -74,6 +94,15 @@ public:
     bool getTargetPositions(double *refs) override;
     bool getTargetPositions(int n_joint, const int *joints, double *refs) override;
 
+    // ------- IPositionDirect declarations. Implementation in IPositionDirectImpl.cpp -------
+
+    bool setPosition(int j, double ref) override;
+    bool setPositions(const int n_joint, const int *joints, const double *refs) override;
+    bool setPositions(const double *refs) override;
+    bool getRefPosition(const int joint, double *ref) override;
+    bool getRefPositions(double *refs) override;
+    bool getRefPositions(const int n_joint, const int *joints, double *refs) override;
+
     // ---------- IEncoders declarations. Implementation in IEncodersImpl.cpp ----------
 
     bool resetEncoder(int j) override;
@@ -122,6 +151,12 @@ public:
     bool getAxisName(int axis, std::string& name) override;
     bool getJointType(int axis, yarp::dev::JointTypeEnum& type) override;
 
+    // ------- IRemoteVariables declarations. Implementation in IRemoteVariablesImpl.cpp -------
+
+    bool getRemoteVariable(std::string key, yarp::os::Bottle& val) override;
+    bool setRemoteVariable(std::string key, const yarp::os::Bottle& val) override;
+    bool getRemoteVariablesList(yarp::os::Bottle* listOfKeys) override;
+
     // --------- ICurrentControl Declarations. Implementation in ICurrentControlImpl.cpp ---------
 
     bool getNumberOfMotors(int *ax) override;
@@ -144,14 +179,22 @@ protected:
      * @param idx index to check.
      * @return true/false on success/failure.
      */
-    bool indexWithinRange(const int& idx);
+    static bool indexWithinRange(const int& idx);
 
     /**
      * Check if number of joints is within range.
      * @param n_joint index to check.
      * @return true/false on success/failure.
      */
-    bool batchWithinRange(const int& n_joint);
+    static bool batchWithinRange(const int& n_joint);
+
+    /**
+     * Check if number of joints and every joint index are within range.
+     * @param n_joint number of joints.
+     * @param joints joint indices.
+     * @return true/false on success/failure.
+     */
+    static bool batchWithinRange(const int& n_joint, const int * joints);
 
     /**
      * Convert from radians to degrees.
@@ -167,13 +210,257 @@ protected:
      */
     static double toRad(double deg);
 
+    /**
+     * Retrieve measured joint positions, either from the state poller or the CAN bus.
+     * @param positions output vector [rad]
+     * @param timestamp if not null, midpoint of the read call window [s]
+     * @return true/false on success/failure.
+     */
+    bool getActualPositions(AMOR_VECTOR7 & positions, double * timestamp = nullptr);
+
+    /**
+     * Retrieve measured joint velocities, either from the state poller or the CAN bus.
+     * @param velocities output vector [rad/s]
+     * @return true/false on success/failure.
+     */
+    bool getActualVelocities(AMOR_VECTOR7 & velocities);
+
+    /**
+     * Retrieve measured motor currents, either from the state poller or the CAN bus.
+     * @param currents output vector [mA]
+     * @return true/false on success/failure.
+     */
+    bool getActualCurrents(AMOR_VECTOR7 & currents);
+
+    /**
+     * Retrieve commanded motor currents, either from the current streamer or the controller.
+     * @param currents output vector [mA]
+     * @return true/false on success/failure.
+     */
+    bool getCommandedCurrents(AMOR_VECTOR7 & currents);
+
+    /**
+     * Command new target positions, either at once or through the trajectory generator.
+     * @param site call site, for bus accounting
+     * @param fn callable that edits the target vector [rad], may veto the move by returning false
+     * @return true/false on success/failure.
+     */
+    template <typename Fn>
+    bool moveTo(const char * site, Fn && fn)
+    {
+        if (trajectoryGenerator)
+        {
+            return trajectoryGenerator->move(std::forward<Fn>(fn));
+        }
+
+        return commandPositions(commandSource, site, std::forward<Fn>(fn));
+    }
+
+    /**
+     * Apply a partial update to the commanded positions and record the resulting targets.
+     * @param origin bus request origin
+     * @param site call site, for bus accounting
+     * @param fn callable that edits the setpoint vector [rad], may veto the command by returning false
+     * @return true/false on success/failure.
+     */
+    template <typename Fn>
+    bool commandPositions(const AmorBus::source & origin, const char * site, Fn && fn)
+    {
+        return bus->call(origin, site, [this, &fn](AMOR_HANDLE handle)
+            {
+                AMOR_VECTOR7 targets;
+
+                auto edit = [&fn, &targets](auto & positions)
+                {
+                    if (!editSetpoints(fn, positions))
+                    {
+                        return false;
+                    }
+
+                    std::copy(positions, positions + AMOR_NUM_JOINTS, targets);
+                    return true;
+                };
+
+                if (!commandedPositions.apply(handle, edit))
+                {
+                    return false;
+                }
+
+                motionTracker.setTargets(targets);
+                return true;
+            });
+    }
+
+    /**
+     * Halt the arm and forget all commanded setpoints, must be called from within a bus request.
+     * @param handle AMOR handle
+     * @return true/false on success/failure.
+     */
+    bool controlledStop(AMOR_HANDLE handle);
+
+    //! Postpone the velocity deadman watchdog, if enabled.
+    void feedVelocityWatchdog();
+
+    /**
+     * Bring the given joints to rest according to the current control mode, the others carry on.
+     * @param n_joint number of joints
+     * @param joints joint indices
+     * @return true/false on success/failure.
+     */
+    bool stopJoints(int n_joint, const int * joints);
+
+    /**
+     * Send a full position setpoint vector and record it as the motion targets.
+     * @param site call site, for bus accounting
+     * @param positions setpoints [rad]
+     * @return true/false on success/failure.
+     */
+    bool sendPositions(const char * site, const AMOR_VECTOR7 & positions);
+
+    /**
+     * Check that the given joints are in the given control mode.
+     * @param mode control mode vocab
+     * @param n_joint number of joints
+     * @param joints joint indices
+     * @return true/false on success/failure.
+     */
+    bool checkControlMode(int mode, int n_joint, const int * joints);
+
+    /**
+     * Check that all joints are in the given control mode.
+     * @param mode control mode vocab
+     * @return true/false on success/failure.
+     */
+    bool checkControlMode(int mode);
+
+    /**
+     * Validate and apply a control mode transition, switching the controller if needed.
+     * @param n_joint number of joints
+     * @param joints joint indices
+     * @param modes control mode vocabs, one per joint
+     * @return true/false on success/failure.
+     */
+    bool switchControlModes(int n_joint, const int * joints, const int * modes);
+
+    /**
+     * Switch the AMOR controller to another kind of setpoint, holding the arm still.
+     * @param family VOCAB_CM_POSITION, VOCAB_CM_VELOCITY or VOCAB_CM_CURRENT
+     * @return true/false on success/failure.
+     */
+    bool enterControlMode(int family);
+
+    /**
+     * Retrieve the hardware position and velocity limits from the cached joint info.
+     * @return lower and upper position limits [rad], lower and upper velocity limits [rad/s].
+     */
+    std::pair<SoftLimits::Range, SoftLimits::Range> getHardLimits() const;
+
+    /**
+     * Check setpoints against soft limits (or clamp them), logging the first violation.
+     * @param limits soft limits to enforce
+     * @param values setpoint vector [rad] or [rad/s]
+     * @param mask selected joints, bit j set for joint j
+     * @param what setpoint kind, for logging purposes
+     * @return true if the command may proceed.
+     */
+    bool enforceLimits(const SoftLimits & limits, AMOR_VECTOR7 & values, unsigned int mask, const char * what);
+
+    /**
+     * Compute motion-done flags for all joints from the measured joint state.
+     * Joints still following a streamed profile are not done. Measured state
+     * is only queried if some joint is not, which without the state poller
+     * (pollPeriodMs) takes two bus reads (positions and velocities).
+     * @param flags output vector, one per joint
+     * @return true/false on success/failure.
+     */
+    bool getMotionDone(bool * flags);
+
+    /**
+     * Retrieve the position targets, either from the trajectory generator or the controller.
+     * @param positions output vector [rad]
+     * @return true/false on success/failure.
+     */
+    bool getTargets(AMOR_VECTOR7 & positions);
+
+    /**
+     * Validate and apply a reference speed for the trajectory generator.
+     * @param j joint index
+     * @param sp reference speed [deg/s]
+     * @return true/false on success/failure.
+     */
+    bool applyRefSpeed(int j, double sp);
+
+    /**
+     * Validate and apply a reference acceleration for the trajectory generator.
+     * @param j joint index
+     * @param acc reference acceleration [deg/s^2]
+     * @return true/false on success/failure.
+     */
+    bool applyRefAcceleration(int j, double acc);
+
 private:
 
+    using JointInfoTable = std::array<AMOR_JOINT_INFO, AMOR_NUM_JOINTS>;
+
+    /**
+     * Query static joint parameters from the controller and fill the local cache.
+     * Only called from open(), hence the single writer of the joint info table, which is
+     * read lock-free afterwards and not refreshed during the lifetime of the device.
+     * @return true/false on success/failure.
+     */
+    bool refreshJointInfo();
+
     AMOR_HANDLE handle {AMOR_INVALID_HANDLE};
-    mutable std::mutex handleMutex;
+    std::unique_ptr<AmorBus> bus;
+    std::unique_ptr<StatePoller> statePoller;
+    std::unique_ptr<TrajectoryGenerator> trajectoryGenerator;
+    std::unique_ptr<CurrentStreamer> currentStreamer;
+    std::unique_ptr<DeadmanWatchdog> velocityWatchdog;
+    double velocityTimeout {0.0};
+    std::unique_ptr<BusMonitor> busMonitor;
+    std::unique_ptr<StopMonitor> stopMonitor;
+    SeqLock<JointInfoTable> jointInfo;
+    std::atomic<double> encoderLatency {0.0};
+
+    // bus request origins, stops take precedence over (and cancel) pending commands,
+    // selective stops only take precedence over them; direct setpoints overtake queued
+    // commands and queries, but are still cancelled by stops
+    AmorBus::source safetySource {"AmorControlBoard/safety", AmorBus::priority::SAFETY, true, false};
+    AmorBus::source commandSource {"AmorControlBoard/command", AmorBus::priority::NORMAL, false, true};
+    AmorBus::source holdSource {"AmorControlBoard/hold", AmorBus::priority::HIGH, false, false};
+    AmorBus::source streamSource {"AmorControlBoard/stream", AmorBus::priority::HIGH, false, false};
+    AmorBus::source directSource {"AmorControlBoard/direct", AmorBus::priority::HIGH, false, true};
+    AmorBus::source monitorSource {"AmorControlBoard/monitor", AmorBus::priority::LOW, false, false};
+
+    // incremented on each motion command sent through the bus, by either device
+    std::atomic<unsigned int> commandCounter {0};
+
+    // partial commands start from the measured positions, or from rest in the other modes
+    CommandShadow commandedPositions {amor_get_req_positions, "amor_get_req_positions",
+                                      amor_get_actual_positions, "amor_get_actual_positions",
+                                      amor_set_positions, "amor_set_positions", commandCounter};
+
+    CommandShadow commandedVelocities {amor_get_req_velocities, "amor_get_req_velocities", nullptr, nullptr,
+                                       amor_set_velocities, "amor_set_velocities", commandCounter};
+
+    CommandShadow commandedCurrents {amor_get_req_currents, "amor_get_req_currents", nullptr, nullptr,
+                                     amor_set_currents, "amor_set_currents", commandCounter};
+
+    MotionTracker motionTracker {commandCounter};
+
+    // checked before queuing any position or velocity command [rad], [rad/s]
+    SoftLimits positionLimits;
+    SoftLimits velocityLimits;
+
+    // per-phase durations of the last call to open() [s]
+    std::vector<std::pair<std::string, double>> startupTimings;
+
     yarp::dev::PolyDriver cartesianControllerDevice;
     bool usingCartesianController {false};
-    int controlMode {VOCAB_CM_POSITION};
+
+    // per-joint modes are read lock-free by command paths, transitions are serialized
+    std::array<std::atomic<int>, AMOR_NUM_JOINTS> controlModes;
+    std::mutex controlModeMutex;
 };
 
 } // namespace roboticslab
@@ -0,0 +1,19 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "BusMonitor.hpp"
+
+#include <yarp/os/Log.h>
+
+#include "LogComponent.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+void BusMonitor::run()
+{
+    yCInfo(ACB, "bus sites (us): %s", bus.formatStats().c_str());
+    yCInfo(ACB, "bus sources (us): %s", bus.formatSourceStats().c_str());
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,34 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_BUS_MONITOR_HPP__
+#define __AMOR_BUS_MONITOR_HPP__
+
+#include <yarp/os/PeriodicThread.h>
+
+#include "AmorBus.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Periodically logs per call site and per source queue and service latencies of the AMOR bus.
+ */
+class BusMonitor : public yarp::os::PeriodicThread
+{
+public:
+    BusMonitor(const AmorBus & bus, double period)
+        : yarp::os::PeriodicThread(period),
+          bus(bus)
+    {}
+
+protected:
+    void run() override;
+
+private:
+    const AmorBus & bus;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_BUS_MONITOR_HPP__
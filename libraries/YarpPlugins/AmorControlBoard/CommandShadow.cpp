@@ -0,0 +1,98 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "CommandShadow.hpp"
+
+#include <yarp/os/Log.h>
+#include <yarp/os/Time.h>
+
+#include "LogComponent.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+bool CommandShadow::write(AMOR_HANDLE handle, const AMOR_VECTOR7 & setpoints)
+{
+    const double now = yarp::os::Time::now();
+
+    // the stored vector keeps the requested setpoints, so that repeated sub-deadband
+    // updates accumulate; the filter compares them against the last ones actually sent
+    std::copy(setpoints, setpoints + AMOR_NUM_JOINTS, values);
+
+    if (filter.suppress(values, commandCounter, now))
+    {
+        return true;
+    }
+
+    if (setter(handle, values) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "%s() failed: %s", setterName, amor_error());
+        valid = false;
+        filter.reset();
+        return false;
+    }
+
+    valid = true;
+    epoch = ++commandCounter;
+    filter.sent(values, epoch, now);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool CommandShadow::read(AmorBus & bus, const AmorBus::source & origin, const char * site, AMOR_VECTOR7 & setpoints)
+{
+    return bus.call(origin, site, [this, &setpoints](AMOR_HANDLE handle)
+        {
+            if (isValid())
+            {
+                std::copy(values, values + AMOR_NUM_JOINTS, setpoints);
+                return true;
+            }
+
+            if (getter(handle, &setpoints) != AMOR_SUCCESS)
+            {
+                yCError(ACB, "%s() failed: %s", getterName, amor_error());
+                return false;
+            }
+
+            return true;
+        });
+}
+
+// -----------------------------------------------------------------------------
+
+bool CommandShadow::baseline(AmorBus & bus, const AmorBus::source & origin, const char * site, AMOR_VECTOR7 & setpoints)
+{
+    return bus.call(origin, site, [this, &setpoints](AMOR_HANDLE handle)
+        {
+            if (!isValid() && !seed(handle))
+            {
+                return false;
+            }
+
+            std::copy(values, values + AMOR_NUM_JOINTS, setpoints);
+            return true;
+        });
+}
+
+// -----------------------------------------------------------------------------
+
+bool CommandShadow::seed(AMOR_HANDLE handle)
+{
+    if (!seeder)
+    {
+        std::fill(values, values + AMOR_NUM_JOINTS, 0.0);
+    }
+    else if (seeder(handle, &values) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "%s() failed: %s", seederName, amor_error());
+        return false;
+    }
+
+    valid = true;
+    epoch = commandCounter;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,150 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_COMMAND_SHADOW_HPP__
+#define __AMOR_COMMAND_SHADOW_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <type_traits>
+
+#include <amor.h>
+
+#include "AmorBus.hpp"
+#include "SetpointFilter.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Apply a setpoint editing callable, which may veto the command by returning false.
+ */
+template <typename Fn>
+bool editSetpoints(Fn && fn, AMOR_VECTOR7 & setpoints)
+{
+    if constexpr (std::is_same_v<std::invoke_result_t<Fn &, AMOR_VECTOR7 &>, bool>)
+    {
+        return fn(setpoints);
+    }
+    else
+    {
+        fn(setpoints);
+        return true;
+    }
+}
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Keeps track of the last setpoint vector sent in a given control mode.
+ *
+ * Partial (single-joint or subset) commands are merged into the stored
+ * vector and sent in a single write, instead of reading back the state of
+ * the remaining joints first. The stored vector is unknown on first use,
+ * after a stop or after any other command was sent to the arm, either in a
+ * different mode or by another client sharing the bus (as signaled by a
+ * shared command counter, which is incremented on each write). Partial
+ * commands are then built upon a neutral seed, i.e. the measured state as
+ * told by the seeder (or zeros if there is none), since the targets still
+ * requested by the controller may belong to an aborted motion; queries
+ * report the latter, though. Redundant writes may be dropped by an optional
+ * setpoint filter. The stored vector is only accessed from the bus I/O thread.
+ */
+class CommandShadow
+{
+public:
+    using getter_t = AMOR_RESULT (*)(AMOR_HANDLE, AMOR_VECTOR7 *);
+    using setter_t = AMOR_RESULT (*)(AMOR_HANDLE, AMOR_VECTOR7);
+
+    /**
+     * @param getter retrieves the setpoints requested by the controller.
+     * @param seeder retrieves the measured state partial commands are built upon, zeros if null.
+     */
+    CommandShadow(getter_t getter, const char * getterName, getter_t seeder, const char * seederName,
+                  setter_t setter, const char * setterName, std::atomic<unsigned int> & commandCounter)
+        : getter(getter),
+          getterName(getterName),
+          seeder(seeder),
+          seederName(seederName),
+          setter(setter),
+          setterName(setterName),
+          commandCounter(commandCounter)
+    {}
+
+    //! Enable duplicate and deadband suppression, see SetpointFilter::configure().
+    void configureFilter(double deadband, double keepAlive)
+    { filter.configure(deadband, keepAlive); }
+
+    //! Sent versus suppressed frames.
+    const SetpointFilter & getFilter() const
+    { return filter; }
+
+    SetpointFilter & getFilter()
+    { return filter; }
+
+    //! Send a full setpoint vector.
+    bool send(AmorBus & bus, const AmorBus::source & origin, const char * site, const AMOR_VECTOR7 & setpoints)
+    { return bus.call(origin, site, [this, &setpoints](AMOR_HANDLE handle) { return write(handle, setpoints); }); }
+
+    //! Apply a partial update to the last known setpoints and send them.
+    template <typename Fn>
+    bool update(AmorBus & bus, const AmorBus::source & origin, const char * site, Fn && fn)
+    { return bus.call(origin, site, [this, &fn](AMOR_HANDLE handle) { return apply(handle, fn); }); }
+
+    //! Retrieve the last setpoints, the controller is queried only if unknown.
+    bool read(AmorBus & bus, const AmorBus::source & origin, const char * site, AMOR_VECTOR7 & setpoints);
+
+    //! Retrieve the setpoints partial commands would build upon, seeding them if unknown.
+    bool baseline(AmorBus & bus, const AmorBus::source & origin, const char * site, AMOR_VECTOR7 & setpoints);
+
+    //! Whether the stored setpoints are still in effect, must be called from within a bus request.
+    bool isValid() const
+    { return valid && commandCounter == epoch; }
+
+    //! Forget stored setpoints, must be called from within a bus request.
+    void invalidate()
+    { valid = false; filter.reset(); }
+
+    //! Send a full setpoint vector, must be called from within a bus request.
+    bool write(AMOR_HANDLE handle, const AMOR_VECTOR7 & setpoints);
+
+    //! Apply a partial update and send it unless vetoed, must be called from within a bus request.
+    template <typename Fn>
+    bool apply(AMOR_HANDLE handle, Fn && fn)
+    {
+        if (!isValid() && !seed(handle))
+        {
+            return false;
+        }
+
+        AMOR_VECTOR7 setpoints;
+        std::copy(values, values + AMOR_NUM_JOINTS, setpoints);
+
+        if (!editSetpoints(fn, setpoints))
+        {
+            return false;
+        }
+
+        return write(handle, setpoints);
+    }
+
+private:
+
+    bool seed(AMOR_HANDLE handle);
+
+    getter_t getter;
+    const char * getterName;
+    getter_t seeder;
+    const char * seederName;
+    setter_t setter;
+    const char * setterName;
+    std::atomic<unsigned int> & commandCounter;
+
+    AMOR_VECTOR7 values {};
+    bool valid {false};
+    unsigned int epoch {0};
+    SetpointFilter filter;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_COMMAND_SHADOW_HPP__
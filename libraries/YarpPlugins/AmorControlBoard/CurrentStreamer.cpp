@@ -0,0 +1,169 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "CurrentStreamer.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+#include <yarp/os/Log.h>
+
+#include "LogComponent.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+void CurrentStreamer::disarm()
+{
+    std::lock_guard lock(mutex);
+    streaming = false;
+}
+
+// -----------------------------------------------------------------------------
+
+bool CurrentStreamer::getReferences(AMOR_VECTOR7 & currents) const
+{
+    std::lock_guard lock(mutex);
+
+    if (!streaming)
+    {
+        return false;
+    }
+
+    std::copy(references, references + AMOR_NUM_JOINTS, currents);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+CurrentStreamer::Stats CurrentStreamer::getStats() const
+{
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+// -----------------------------------------------------------------------------
+
+void CurrentStreamer::resetStats()
+{
+    std::lock_guard lock(mutex);
+    stats = {};
+    totalJitter = 0.0;
+}
+
+// -----------------------------------------------------------------------------
+
+void CurrentStreamer::begin(const AMOR_VECTOR7 & seed)
+{
+    std::copy(seed, seed + AMOR_NUM_JOINTS, references);
+    streaming = true;
+    epoch = commandCounter;
+    session++;
+    lastCycle = 0.0;
+}
+
+// -----------------------------------------------------------------------------
+
+void CurrentStreamer::run()
+{
+    AMOR_VECTOR7 currents;
+    unsigned int sentEpoch, sentSession;
+    bool expired = false;
+
+    {
+        std::lock_guard lock(mutex);
+
+        if (!streaming)
+        {
+            return;
+        }
+
+        const double now = yarp::os::Time::now();
+
+        if (lastCycle != 0.0)
+        {
+            const double jitter = std::abs(now - lastCycle - period);
+
+            stats.cycles++;
+            stats.overruns += jitter > period / 2.0;
+            stats.maxJitter = std::max(stats.maxJitter, jitter);
+            totalJitter += jitter;
+            stats.meanJitter = totalJitter / stats.cycles;
+        }
+
+        lastCycle = now;
+
+        if (now - lastUpdate > timeout)
+        {
+            yCWarning(ACB, "No current references received in %f s, stopping", now - lastUpdate);
+            stats.timeouts++;
+            streaming = false;
+            expired = true;
+            sentEpoch = epoch;
+        }
+        else
+        {
+            std::copy(references, references + AMOR_NUM_JOINTS, currents);
+            sentEpoch = epoch;
+            sentSession = session;
+        }
+    }
+
+    if (expired)
+    {
+        trip(sentEpoch);
+        return;
+    }
+
+    // clients are not blocked while the bus is busy
+    bool ok = bus.call(origin, "CurrentStreamer", [this, &currents, &sentEpoch](AMOR_HANDLE handle)
+        {
+            if (commandCounter != sentEpoch)
+            {
+                yCDebug(ACB, "Current streaming superseded by another command");
+                return false;
+            }
+
+            if (!shadow.write(handle, currents))
+            {
+                return false;
+            }
+
+            sentEpoch = commandCounter;
+            return true;
+        });
+
+    std::lock_guard lock(mutex);
+
+    // ignore the outcome if streaming was restarted meanwhile
+    if (session == sentSession)
+    {
+        if (ok)
+        {
+            epoch = sentEpoch;
+        }
+        else
+        {
+            streaming = false;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void CurrentStreamer::trip(unsigned int lastEpoch)
+{
+    bus.call(safety, "CurrentStreamer", [this, lastEpoch](AMOR_HANDLE handle)
+        {
+            // nothing to do if superseded by any other command, including a stop
+            if (commandCounter != lastEpoch)
+            {
+                return true;
+            }
+
+            return stopArm(handle);
+        });
+}
+
+// -----------------------------------------------------------------------------
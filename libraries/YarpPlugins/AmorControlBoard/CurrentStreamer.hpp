@@ -0,0 +1,149 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_CURRENT_STREAMER_HPP__
+#define __AMOR_CURRENT_STREAMER_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include <yarp/os/PeriodicThread.h>
+#include <yarp/os/Time.h>
+
+#include <amor.h>
+
+#include "AmorBus.hpp"
+#include "CommandShadow.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Sends current references to the arm at a fixed rate.
+ *
+ * Client commands only update a local reference vector, which is seeded from
+ * the current command shadow (or zeros, if no references are in effect) on
+ * first use. Streaming starts with the first
+ * reference and continues until either references stop arriving within the
+ * watchdog timeout, in which case the arm is brought to a controlled stop
+ * through the same handler as any other stop request (unless another command
+ * took over since the last streamed frame), or any other command
+ * reaches the arm (as signaled by the shared command
+ * counter). Cycle-to-cycle jitter is measured against the nominal period.
+ */
+class CurrentStreamer : public yarp::os::PeriodicThread
+{
+public:
+    //! Loop statistics, jitter in seconds.
+    struct Stats
+    {
+        unsigned long cycles;
+        unsigned long overruns; //!< cycles delayed by more than half a period
+        unsigned int timeouts; //!< watchdog trips
+        double meanJitter;
+        double maxJitter;
+    };
+
+    //! Bring the arm to a controlled stop, runs on the bus I/O thread.
+    using stop_t = std::function<bool(AMOR_HANDLE)>;
+
+    CurrentStreamer(AmorBus & bus, const AmorBus::source & origin, const AmorBus::source & safety,
+                    CommandShadow & shadow, std::atomic<unsigned int> & commandCounter,
+                    double period, double timeout, stop_t stopArm)
+        : yarp::os::PeriodicThread(period),
+          bus(bus),
+          origin(origin),
+          safety(safety),
+          shadow(shadow),
+          stopArm(std::move(stopArm)),
+          commandCounter(commandCounter),
+          period(period),
+          timeout(timeout)
+    {}
+
+    /**
+     * Update the local references and feed the watchdog, never waits for the bus.
+     * @param fn callable that edits the reference vector [mA], may veto the update by returning false
+     * @return true/false on success/failure.
+     */
+    template <typename Fn>
+    bool update(Fn && fn)
+    {
+        std::unique_lock lock(mutex);
+
+        if (!streaming)
+        {
+            // the loop must not stall while the seed is retrieved from the bus
+            lock.unlock();
+            AMOR_VECTOR7 seed;
+
+            if (!shadow.baseline(bus, origin, "CurrentStreamer", seed))
+            {
+                return false;
+            }
+
+            lock.lock();
+
+            // another client may have started streaming meanwhile
+            if (!streaming)
+            {
+                begin(seed);
+            }
+        }
+
+        AMOR_VECTOR7 edited;
+        std::copy(references, references + AMOR_NUM_JOINTS, edited);
+
+        if (!editSetpoints(fn, edited))
+        {
+            return false;
+        }
+
+        std::copy(edited, edited + AMOR_NUM_JOINTS, references);
+        lastUpdate = yarp::os::Time::now();
+        return true;
+    }
+
+    //! Stop streaming, the arm keeps the last references.
+    void disarm();
+
+    //! Retrieve the streamed references, false if idle.
+    bool getReferences(AMOR_VECTOR7 & currents) const;
+
+    Stats getStats() const;
+
+    void resetStats();
+
+protected:
+    void run() override;
+
+private:
+    void begin(const AMOR_VECTOR7 & seed);
+    void trip(unsigned int lastEpoch);
+
+    AmorBus & bus;
+    const AmorBus::source origin;
+    const AmorBus::source safety;
+    CommandShadow & shadow;
+    const stop_t stopArm;
+    std::atomic<unsigned int> & commandCounter;
+    const double period;
+    const double timeout;
+
+    mutable std::mutex mutex;
+    AMOR_VECTOR7 references {};
+    bool streaming {false};
+    double lastUpdate {0.0};
+    double lastCycle {0.0};
+    double totalJitter {0.0};
+    unsigned int epoch {0};
+    unsigned int session {0};
+    Stats stats {};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_CURRENT_STREAMER_HPP__
@@ -2,9 +2,14 @@
 
 #include "AmorControlBoard.hpp"
 
+#include <future>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <yarp/os/LogStream.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Time.h>
 
 #include "LogComponent.hpp"
 
@@ -12,11 +17,107 @@ using namespace roboticslab;
 
 constexpr auto DEFAULT_CAN_LIBRARY = "libeddriver.so";
 constexpr auto DEFAULT_CAN_PORT = 0;
+constexpr auto DEFAULT_POLL_PERIOD_MS = 0; // disabled
+constexpr auto DEFAULT_ACCELERATION_WINDOW = 5;
+constexpr auto DEFAULT_BUS_STATS_PERIOD = 0.0; // disabled
+constexpr auto DEFAULT_PARALLEL_INIT = false;
+constexpr auto DEFAULT_COMMAND_PRIORITY = "normal";
+constexpr auto DEFAULT_MONITOR_PRIORITY = "low";
+constexpr auto DEFAULT_COMMAND_PREEMPTIBLE = true;
+constexpr auto DEFAULT_SETPOINT_KEEP_ALIVE = 0.0; // disabled
+constexpr auto DEFAULT_POSITION_DEADBAND = 0.0;
+constexpr auto DEFAULT_VELOCITY_DEADBAND = 0.0;
+constexpr auto DEFAULT_CURRENT_DEADBAND = 0.0;
+constexpr auto DEFAULT_TRAJECTORY_PERIOD_MS = 0; // disabled
+constexpr auto DEFAULT_POSITION_TOLERANCE = 0.2;
+constexpr auto DEFAULT_VELOCITY_TOLERANCE = 0.5;
+constexpr auto DEFAULT_STOP_MONITOR_PERIOD = 0.01; // if not polling
+constexpr auto DEFAULT_CURRENT_STREAM_PERIOD_MS = 0; // disabled
+constexpr auto DEFAULT_CURRENT_STREAM_TIMEOUT = 0.1;
+constexpr auto DEFAULT_VELOCITY_TIMEOUT_MS = 0; // disabled
+constexpr auto DEFAULT_LIMIT_POLICY = "reject";
 
 // ------------------- DeviceDriver related ------------------------------------
 
 bool AmorControlBoard::open(yarp::os::Searchable& config)
 {
+    startupTimings.clear();
+
+    for (auto & mode : controlModes)
+    {
+        mode = VOCAB_CM_POSITION;
+    }
+
+    const double startupStart = yarp::os::Time::now();
+    double phaseStart = startupStart;
+
+    auto endPhase = [this, &phaseStart](const char * phase)
+    {
+        double now = yarp::os::Time::now();
+        startupTimings.emplace_back(phase, now - phaseStart);
+        phaseStart = now;
+    };
+
+    auto commandPriority = config.check("commandPriority", yarp::os::Value(DEFAULT_COMMAND_PRIORITY),
+            "bus priority of joint commands (safety, high, normal, low)").asString();
+
+    auto monitorPriority = config.check("monitorPriority", yarp::os::Value(DEFAULT_MONITOR_PRIORITY),
+            "bus priority of state queries (safety, high, normal, low)").asString();
+
+    if (!AmorBus::parsePriority(commandPriority, commandSource.level)
+        || !AmorBus::parsePriority(monitorPriority, monitorSource.level))
+    {
+        yCError(ACB, "Illegal bus priority: %s, %s", commandPriority.c_str(), monitorPriority.c_str());
+        return false;
+    }
+
+    commandSource.preemptible = config.check("commandPreemptible", yarp::os::Value(DEFAULT_COMMAND_PREEMPTIBLE),
+            "whether queued joint commands are discarded by subsequent stops").asBool();
+
+    directSource.preemptible = commandSource.preemptible;
+
+    double setpointKeepAlive = config.check("setpointKeepAlive", yarp::os::Value(DEFAULT_SETPOINT_KEEP_ALIVE),
+            "resend period of unchanged setpoints, redundant ones are suppressed (seconds, 0 to disable)").asFloat64();
+
+    double positionDeadband = config.check("positionDeadband", yarp::os::Value(DEFAULT_POSITION_DEADBAND),
+            "position setpoint deadband (degrees)").asFloat64();
+
+    double velocityDeadband = config.check("velocityDeadband", yarp::os::Value(DEFAULT_VELOCITY_DEADBAND),
+            "velocity setpoint deadband (degrees/second)").asFloat64();
+
+    double currentDeadband = config.check("currentDeadband", yarp::os::Value(DEFAULT_CURRENT_DEADBAND),
+            "current setpoint deadband (milliamperes)").asFloat64();
+
+    commandedPositions.configureFilter(toRad(positionDeadband), setpointKeepAlive);
+    commandedVelocities.configureFilter(toRad(velocityDeadband), setpointKeepAlive);
+    commandedCurrents.configureFilter(currentDeadband, setpointKeepAlive);
+
+    double positionTolerance = config.check("positionTolerance", yarp::os::Value(DEFAULT_POSITION_TOLERANCE),
+            "distance to target below which a joint is considered done (degrees)").asFloat64();
+
+    double velocityTolerance = config.check("velocityTolerance", yarp::os::Value(DEFAULT_VELOCITY_TOLERANCE),
+            "speed below which a joint is considered at rest (degrees/second)").asFloat64();
+
+    if (positionTolerance < 0.0 || velocityTolerance < 0.0)
+    {
+        yCError(ACB, "Illegal motion-done tolerances: %f, %f (must be non-negative)", positionTolerance, velocityTolerance);
+        return false;
+    }
+
+    motionTracker.configure(toRad(positionTolerance), toRad(velocityTolerance));
+
+    auto limitPolicy = config.check("limitPolicy", yarp::os::Value(DEFAULT_LIMIT_POLICY),
+            "handling of setpoints beyond soft joint and velocity limits (reject, clamp)").asString();
+
+    if (limitPolicy != "reject" && limitPolicy != "clamp")
+    {
+        yCError(ACB, "Illegal limit policy: %s", limitPolicy.c_str());
+        return false;
+    }
+
+    positionLimits.setClamping(limitPolicy == "clamp");
+    velocityLimits.setClamping(limitPolicy == "clamp");
+
     int major, minor, build;
     amor_get_library_version(&major, &minor, &build);
 
@@ -33,25 +134,268 @@ bool AmorControlBoard::open(yarp::os::Searchable& config)
 
     yCInfo(ACB) << "Acquired AMOR handle!";
 
-    AMOR_JOINT_INFO jointInfo[AMOR_NUM_JOINTS];
+    // from now on, the handle is only accessed through the I/O thread
+    bus = std::make_unique<AmorBus>(handle, yarp::os::Time::now);
+
+    if (!bus->start())
+    {
+        yCError(ACB) << "Unable to start AMOR bus thread";
+        return false;
+    }
+
+    endPhase("connect");
+
+    if (!refreshJointInfo())
+    {
+        return false;
+    }
+
+    endPhase("jointInfo");
+
+    // soft limits start at the hardware ones, clients may narrow them later on
+    const auto hardLimits = getHardLimits();
+    positionLimits.reset(hardLimits.first);
+    velocityLimits.reset(hardLimits.second);
+
+    // the cartesian controller only needs the bus and the joint limits, hence its solver
+    // (which takes a while to parse the kinematic description) may be set up in parallel
+    // with everything else from here on; it cannot start any earlier, since the joint
+    // limits are passed to the solver at open time
+    yarp::os::Value * cartesianControllerName;
+    std::future<std::pair<bool, double>> cartesianControllerReady; // {valid, elapsed [s]}
+
+    // early failures past this point wait for the concurrent open (close() releases the
+    // device), the task must not outlive this call nor race with close()
+    struct StartupJoin
+    {
+        std::future<std::pair<bool, double>> & task;
+        ~StartupJoin() { if (task.valid()) task.wait(); }
+    } cartesianControllerJoin {cartesianControllerReady};
+
+    bool parallelInit = config.check("parallelInit", yarp::os::Value(DEFAULT_PARALLEL_INIT),
+            "open the cartesian controller concurrently with the remaining CAN initialization").asBool();
+
+    if (config.check("cartesianControllerName", cartesianControllerName, "cartesian controller port"))
+    {
+        yCInfo(ACB) << "Using AMOR cartesian controller device";
+
+        usingCartesianController = true;
+
+        std::string subdevice = "AmorCartesianControl";
+
+        // blobs are copied, pass addresses of shared objects instead of their contents
+        AmorBus * pBus = bus.get();
+        std::atomic<unsigned int> * pCommandCounter = &commandCounter;
+        JointInfoTable jointInfoTable = jointInfo.load();
+
+        yarp::os::Value vBus(&pBus, sizeof(pBus));
+        yarp::os::Value vCommandCounter(&pCommandCounter, sizeof(pCommandCounter));
+        yarp::os::Value vJointInfo(jointInfoTable.data(), sizeof(jointInfoTable));
+        yarp::os::Property cartesianControllerOptions;
+
+        cartesianControllerOptions.fromString((config.toString()));
+        cartesianControllerOptions.put("device", "CartesianControlServer");
+        cartesianControllerOptions.put("subdevice", subdevice);
+        cartesianControllerOptions.put("name", cartesianControllerName->asString());
+        cartesianControllerOptions.put("bus", vBus);
+        cartesianControllerOptions.put("commandCounter", vCommandCounter);
+        cartesianControllerOptions.put("jointInfo", vJointInfo);
+
+        auto openCartesianController = [this](yarp::os::Property options)
+        {
+            double start = yarp::os::Time::now();
+            bool ok = cartesianControllerDevice.open(options) && cartesianControllerDevice.isValid();
+            return std::make_pair(ok, yarp::os::Time::now() - start);
+        };
+
+        if (parallelInit)
+        {
+            cartesianControllerReady = std::async(std::launch::async, openCartesianController, cartesianControllerOptions);
+        }
+        else
+        {
+            std::promise<std::pair<bool, double>> promise;
+            promise.set_value(openCartesianController(cartesianControllerOptions));
+            cartesianControllerReady = promise.get_future();
+            endPhase("cartesianController");
+        }
+    }
+
     int jointStatus[AMOR_NUM_JOINTS];
 
-    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    bool statusOk = bus->call(monitorSource, __func__, [&jointStatus](AMOR_HANDLE handle)
+        {
+            for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+            {
+                if (amor_get_status(handle, j, &jointStatus[j]) != AMOR_SUCCESS)
+                {
+                    yCError(ACB) << "amor_get_status() failed for joint" << j << "with error:" << amor_error();
+                    return false;
+                }
+            }
+
+            return true;
+        });
+
+    if (!statusOk)
+    {
+        return false;
+    }
+
+    endPhase("jointStatus");
+
+    int pollPeriodMs = config.check("pollPeriodMs", yarp::os::Value(DEFAULT_POLL_PERIOD_MS),
+            "joint state acquisition period (milliseconds, 0 to disable)").asInt32();
+
+    int accelerationWindow = config.check("accelerationWindow", yarp::os::Value(DEFAULT_ACCELERATION_WINDOW),
+            "number of samples used to estimate joint accelerations").asInt32();
+
+    if (accelerationWindow < (int)EncoderHistory::MIN_WINDOW || accelerationWindow > (int)EncoderHistory::CAPACITY)
     {
-        if (amor_get_joint_info(handle, j, &jointInfo[j]) != AMOR_SUCCESS)
+        yCError(ACB, "Illegal acceleration window: %d (must be in range [%zu, %zu])",
+                accelerationWindow, EncoderHistory::MIN_WINDOW, EncoderHistory::CAPACITY);
+        return false;
+    }
+
+    if (pollPeriodMs > 0)
+    {
+        statePoller = std::make_unique<StatePoller>(*bus, monitorSource, pollPeriodMs / 1000.0, accelerationWindow);
+
+        if (!statePoller->start())
         {
-            yCError(ACB) << "amor_get_joint_info() failed for joint" << j << "with error:" << amor_error();
+            yCError(ACB) << "Unable to start state poller thread";
+            statePoller.reset();
             return false;
         }
 
-        if (amor_get_status(handle, j, &jointStatus[j]) != AMOR_SUCCESS)
+        yCInfo(ACB) << "Started state poller thread with period" << pollPeriodMs << "ms";
+    }
+
+    double busStatsPeriod = config.check("busStatsPeriod", yarp::os::Value(DEFAULT_BUS_STATS_PERIOD),
+            "period of bus statistics logging (seconds, 0 to disable)").asFloat64();
+
+    if (busStatsPeriod > 0.0)
+    {
+        busMonitor = std::make_unique<BusMonitor>(*bus, busStatsPeriod);
+
+        if (!busMonitor->start())
         {
-            yCError(ACB) << "amor_get_status() failed for joint" << j << "with error:" << amor_error();
+            yCError(ACB) << "Unable to start bus monitor thread";
+            busMonitor.reset();
             return false;
         }
     }
 
-    std::vector<double> positions;
+    stopMonitor = std::make_unique<StopMonitor>(*bus, monitorSource, statePoller.get(), toRad(velocityTolerance),
+                                                pollPeriodMs > 0 ? pollPeriodMs / 1000.0 : DEFAULT_STOP_MONITOR_PERIOD);
+
+    if (!stopMonitor->start())
+    {
+        yCError(ACB) << "Unable to start stop monitor thread";
+        stopMonitor.reset();
+        return false;
+    }
+
+    int trajectoryPeriodMs = config.check("trajectoryPeriodMs", yarp::os::Value(DEFAULT_TRAJECTORY_PERIOD_MS),
+            "period of the position trajectory generator, honors reference speeds and accelerations (milliseconds, 0 to disable)").asInt32();
+
+    if (trajectoryPeriodMs > 0)
+    {
+        trajectoryGenerator = std::make_unique<TrajectoryGenerator>(*bus, commandSource, commandedPositions, motionTracker,
+                                                                    commandCounter, trajectoryPeriodMs / 1000.0);
+
+        // start with the controller's own limits
+        const auto table = jointInfo.load();
+
+        for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+        {
+            // profiles are planned by dividing by these
+            if (table[j].maxVelocity <= 0.0 || table[j].maxAcceleration <= 0.0)
+            {
+                yCError(ACB, "Illegal joint limits reported for joint %d: velocity %f, acceleration %f (must be positive)",
+                        j, table[j].maxVelocity, table[j].maxAcceleration);
+                trajectoryGenerator.reset();
+                return false;
+            }
+
+            trajectoryGenerator->setRefSpeed(j, table[j].maxVelocity);
+            trajectoryGenerator->setRefAcceleration(j, table[j].maxAcceleration);
+        }
+
+        if (!trajectoryGenerator->start())
+        {
+            yCError(ACB) << "Unable to start trajectory generator thread";
+            trajectoryGenerator.reset();
+            return false;
+        }
+
+        yCInfo(ACB) << "Started trajectory generator thread with period" << trajectoryPeriodMs << "ms";
+    }
+
+    int currentStreamPeriodMs = config.check("currentStreamPeriodMs", yarp::os::Value(DEFAULT_CURRENT_STREAM_PERIOD_MS),
+            "period of the current reference streaming loop (milliseconds, 0 to disable)").asInt32();
+
+    double currentStreamTimeout = config.check("currentStreamTimeout", yarp::os::Value(DEFAULT_CURRENT_STREAM_TIMEOUT),
+            "stop the arm if no current references arrive within this time while streaming (seconds)").asFloat64();
+
+    if (currentStreamPeriodMs > 0)
+    {
+        if (currentStreamTimeout <= currentStreamPeriodMs / 1000.0)
+        {
+            yCError(ACB, "Illegal current stream timeout: %f (must be greater than the period)", currentStreamTimeout);
+            return false;
+        }
+
+        currentStreamer = std::make_unique<CurrentStreamer>(*bus, streamSource, safetySource, commandedCurrents,
+                                                            commandCounter, currentStreamPeriodMs / 1000.0,
+                                                            currentStreamTimeout,
+                                                            [this](AMOR_HANDLE handle) { return controlledStop(handle); });
+
+        if (!currentStreamer->start())
+        {
+            yCError(ACB) << "Unable to start current streamer thread";
+            currentStreamer.reset();
+            return false;
+        }
+
+        yCInfo(ACB) << "Started current streamer thread with period" << currentStreamPeriodMs << "ms";
+    }
+
+    int velocityTimeoutMs = config.check("velocityTimeoutMs", yarp::os::Value(DEFAULT_VELOCITY_TIMEOUT_MS),
+            "stop the arm if no velocity command arrives within this time (milliseconds, 0 to disable)").asInt32();
+
+    if (velocityTimeoutMs > 0)
+    {
+        velocityTimeout = velocityTimeoutMs / 1000.0;
+
+        velocityWatchdog = std::make_unique<DeadmanWatchdog>([this]
+            {
+                bus->call(safetySource, "velocityWatchdog", [this](AMOR_HANDLE handle)
+                    {
+                        // nothing to do if superseded by any other command, including a stop
+                        if (!commandedVelocities.isValid())
+                        {
+                            return true;
+                        }
+
+                        yCWarning(ACB, "No velocity command received in %f s, stopping", velocityTimeout);
+                        return controlledStop(handle);
+                    });
+            });
+
+        if (!velocityWatchdog->start())
+        {
+            yCError(ACB) << "Unable to start velocity watchdog thread";
+            velocityWatchdog.reset();
+            return false;
+        }
+
+        yCInfo(ACB) << "Started velocity watchdog with timeout" << velocityTimeoutMs << "ms";
+    }
+
+    endPhase("threads");
+
+    std::vector<double> positions(AMOR_NUM_JOINTS);
 
     if (!getEncoders(positions.data()))
     {
@@ -68,35 +412,67 @@ bool AmorControlBoard::open(yarp::os::Searchable& config)
         return false;
     }
 
-    yarp::os::Value * cartesianControllerName;
+    endPhase("initialPosition");
 
-    if (config.check("cartesianControllerName", cartesianControllerName, "cartesian controller port"))
+    if (cartesianControllerReady.valid())
     {
-        yCInfo(ACB) << "Using AMOR cartesian controller device";
+        auto [cartesianControllerOk, cartesianControllerElapsed] = cartesianControllerReady.get();
 
-        usingCartesianController = true;
+        if (!cartesianControllerOk)
+        {
+            yCError(ACB) << "AMOR cartesian controller device not valid";
+            return false;
+        }
 
-        std::string subdevice = "AmorCartesianControl";
-        yarp::os::Value vHandle(&handle, sizeof(handle));
-        yarp::os::Value vHandleMutex(&handleMutex, sizeof(handleMutex));
-        yarp::os::Property cartesianControllerOptions;
+        if (parallelInit)
+        {
+            // the gain is the part of the open that overlapped the remaining initialization
+            const double waited = yarp::os::Time::now() - phaseStart;
+            endPhase("cartesianControllerWait");
+            startupTimings.emplace_back("cartesianController", cartesianControllerElapsed);
+            startupTimings.emplace_back("cartesianControllerSaved", cartesianControllerElapsed - waited);
+        }
+    }
 
-        cartesianControllerOptions.fromString((config.toString()));
-        cartesianControllerOptions.put("device", "CartesianControlServer");
-        cartesianControllerOptions.put("subdevice", subdevice);
-        cartesianControllerOptions.put("name", cartesianControllerName->asString());
-        cartesianControllerOptions.put("handle", vHandle);
-        cartesianControllerOptions.put("handleMutex", vHandleMutex);
+    startupTimings.emplace_back("total", yarp::os::Time::now() - startupStart);
 
-        cartesianControllerDevice.open(cartesianControllerOptions);
+    std::string timings;
+
+    for (const auto & [phase, elapsed] : startupTimings)
+    {
+        timings += " " + phase + "=" + std::to_string(elapsed * 1000.0);
+    }
 
-        if (!cartesianControllerDevice.isValid())
+    yCInfo(ACB, "Startup timings (ms):%s", timings.c_str());
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::refreshJointInfo()
+{
+    JointInfoTable table;
+
+    bool ok = bus->call(monitorSource, __func__, [&table](AMOR_HANDLE handle)
         {
-            yCError(ACB) << "AMOR cartesian controller device not valid";
-            return false;
-        }
+            for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+            {
+                if (amor_get_joint_info(handle, j, &table[j]) != AMOR_SUCCESS)
+                {
+                    yCError(ACB) << "amor_get_joint_info() failed for joint" << j << "with error:" << amor_error();
+                    return false;
+                }
+            }
+
+            return true;
+        });
+
+    if (!ok)
+    {
+        return false;
     }
 
+    jointInfo.store(table);
     return true;
 }
 
@@ -109,11 +485,52 @@ bool AmorControlBoard::close()
         cartesianControllerDevice.close();
     }
 
+    if (velocityWatchdog)
+    {
+        velocityWatchdog->stop();
+        velocityWatchdog.reset();
+    }
+
+    if (currentStreamer)
+    {
+        currentStreamer->stop();
+        currentStreamer.reset();
+    }
+
+    if (trajectoryGenerator)
+    {
+        trajectoryGenerator->stop();
+        trajectoryGenerator.reset();
+    }
+
+    if (stopMonitor)
+    {
+        stopMonitor->stop();
+        stopMonitor.reset();
+    }
+
+    if (statePoller)
+    {
+        statePoller->stop();
+        statePoller.reset();
+    }
+
+    if (busMonitor)
+    {
+        busMonitor->stop();
+        busMonitor.reset();
+    }
+
+    if (bus)
+    {
+        bus->call(safetySource, __func__, [](AMOR_HANDLE handle) { return amor_emergency_stop(handle); });
+        bus->stop();
+        bus.reset();
+    }
+
     if (handle != AMOR_INVALID_HANDLE)
     {
-        amor_emergency_stop(handle);
         amor_release(handle);
-
         handle = AMOR_INVALID_HANDLE;
     }
 
@@ -0,0 +1,88 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "EncoderHistory.hpp"
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+EncoderHistory::EncoderHistory(std::size_t window)
+    : window(std::clamp(window, MIN_WINDOW, CAPACITY))
+{}
+
+// -----------------------------------------------------------------------------
+
+void EncoderHistory::push(double timestamp, const AMOR_VECTOR7 & positions, const AMOR_VECTOR7 & velocities)
+{
+    auto & entry = entries[head];
+
+    entry.timestamp = timestamp;
+    std::copy(positions, positions + AMOR_NUM_JOINTS, entry.positions);
+    std::copy(velocities, velocities + AMOR_NUM_JOINTS, entry.velocities);
+
+    head = (head + 1) % CAPACITY;
+    count = std::min(count + 1, CAPACITY);
+}
+
+// -----------------------------------------------------------------------------
+
+bool EncoderHistory::estimateAccelerations(AMOR_VECTOR7 & accelerations) const
+{
+    const auto n = std::min(count, window);
+
+    if (n < MIN_WINDOW)
+    {
+        return false;
+    }
+
+    // timestamps are taken relative to the newest sample to preserve precision
+    const double t0 = recent(0).timestamp;
+    double tMean = 0.0;
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        tMean += recent(i).timestamp - t0;
+    }
+
+    tMean /= n;
+
+    double tVar = 0.0;
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        const double dt = recent(i).timestamp - t0 - tMean;
+        tVar += dt * dt;
+    }
+
+    if (tVar <= 0.0)
+    {
+        return false;
+    }
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        double vMean = 0.0;
+
+        for (std::size_t i = 0; i < n; i++)
+        {
+            vMean += recent(i).velocities[j];
+        }
+
+        vMean /= n;
+
+        double cov = 0.0;
+
+        for (std::size_t i = 0; i < n; i++)
+        {
+            cov += (recent(i).timestamp - t0 - tMean) * (recent(i).velocities[j] - vMean);
+        }
+
+        accelerations[j] = cov / tVar;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,64 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_ENCODER_HISTORY_HPP__
+#define __AMOR_ENCODER_HISTORY_HPP__
+
+#include <array>
+#include <cstddef>
+
+#include <amor.h>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Fixed-size ring buffer of timestamped joint state samples.
+ *
+ * Accelerations are estimated as the least-squares slope of the joint
+ * velocities over a sliding window of the most recent samples, which
+ * tolerates non-uniform sampling periods. A window of two samples
+ * amounts to a plain finite difference. Not thread-safe.
+ */
+class EncoderHistory
+{
+public:
+    //! Maximum number of samples kept in the buffer.
+    static constexpr std::size_t CAPACITY = 32;
+
+    //! Minimum number of samples required to estimate accelerations.
+    static constexpr std::size_t MIN_WINDOW = 2;
+
+    explicit EncoderHistory(std::size_t window);
+
+    //! Append a sample, overwriting the oldest one if full.
+    void push(double timestamp, const AMOR_VECTOR7 & positions, const AMOR_VECTOR7 & velocities);
+
+    //! Estimate joint accelerations [rad/s^2], false if not enough samples.
+    bool estimateAccelerations(AMOR_VECTOR7 & accelerations) const;
+
+    //! Drop all stored samples.
+    void clear()
+    { count = 0; }
+
+private:
+    struct Entry
+    {
+        double timestamp;
+        AMOR_VECTOR7 positions;
+        AMOR_VECTOR7 velocities;
+    };
+
+    //! Access the i-th most recent sample (0 is the newest one).
+    const Entry & recent(std::size_t i) const
+    { return entries[(head + CAPACITY - 1 - i) % CAPACITY]; }
+
+    std::array<Entry, CAPACITY> entries;
+    std::size_t head {0};
+    std::size_t count {0};
+    std::size_t window;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_ENCODER_HISTORY_HPP__
@@ -2,6 +2,8 @@
 
 #include "AmorControlBoard.hpp"
 
+#include <cmath>
+
 #include <yarp/os/Log.h>
 
 #include "LogComponent.hpp"
@@ -10,10 +12,31 @@ using namespace roboticslab;
 
 // ------------------- IControlLimits related ------------------------------------
 
+// Soft limits are enforced locally on every position and velocity command, see
+// enforceLimits(). They may be narrowed down, but never beyond the hardware ones.
+
 bool AmorControlBoard::setLimits(int axis, double min, double max)
 {
-    yCError(ACB, "setLimits() not available");
-    return false;
+    yCTrace(ACB, "%d %f %f", axis, min, max);
+
+    if (!indexWithinRange(axis))
+    {
+        return false;
+    }
+
+    const auto hardware = getHardLimits().first;
+    const double lower = toDeg(hardware.lower[axis]);
+    const double upper = toDeg(hardware.upper[axis]);
+
+    if (min >= max || min < lower || max > upper)
+    {
+        yCError(ACB, "Illegal joint limits for joint %d: [%f, %f] (must be an interval within [%f, %f] deg)",
+                axis, min, max, lower, upper);
+        return false;
+    }
+
+    positionLimits.set(axis, toRad(min), toRad(max));
+    return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -27,59 +50,105 @@ bool AmorControlBoard::getLimits(int axis, double *min, double *max)
         return false;
     }
 
-    AMOR_JOINT_INFO parameters;
+    const auto range = positionLimits.get();
+
+    *min = toDeg(range.lower[axis]);
+    *max = toDeg(range.upper[axis]);
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::setVelLimits(int axis, double min, double max)
+{
+    yCTrace(ACB, "%d %f %f", axis, min, max);
 
-    if (std::lock_guard lock(handleMutex); amor_get_joint_info(handle, axis, &parameters) != AMOR_SUCCESS)
+    if (!indexWithinRange(axis))
     {
-        yCError(ACB, "amor_get_joint_info() failed: %s", amor_error());
         return false;
     }
 
-    if (parameters.lowerJointLimit == 0.0 && parameters.upperJointLimit == 0.0)
-    {
-        *min = -180.0;
-        *max = 180.0;
-    }
-    else
+    const double limit = toDeg(getHardLimits().second.upper[axis]);
+
+    if (min >= max || min < -limit || max > limit)
     {
-        *min = toDeg(parameters.lowerJointLimit);
-        *max = toDeg(parameters.upperJointLimit);
+        yCError(ACB, "Illegal velocity limits for joint %d: [%f, %f] (must be an interval within [%f, %f] deg/s)",
+                axis, min, max, -limit, limit);
+        return false;
     }
 
+    velocityLimits.set(axis, toRad(min), toRad(max));
     return true;
 }
 
 // -----------------------------------------------------------------------------
 
-bool AmorControlBoard::setVelLimits(int axis, double min, double max)
+bool AmorControlBoard::getVelLimits(int axis, double *min, double *max)
 {
-    yCError(ACB, "setVelLimits() not available");
-    return false;
+    yCTrace(ACB, "%d", axis);
+
+    if (!indexWithinRange(axis))
+    {
+        return false;
+    }
+
+    const auto range = velocityLimits.get();
+
+    *min = toDeg(range.lower[axis]);
+    *max = toDeg(range.upper[axis]);
+
+    return true;
 }
 
 // -----------------------------------------------------------------------------
 
-bool AmorControlBoard::getVelLimits(int axis, double *min, double *max)
+std::pair<SoftLimits::Range, SoftLimits::Range> AmorControlBoard::getHardLimits() const
 {
-    yCTrace(ACB, "%d", axis);
+    const auto table = jointInfo.load();
+    SoftLimits::Range positions, velocities;
 
-    if (!indexWithinRange(axis))
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
     {
-        return false;
+        const auto & parameters = table[j];
+
+        if (parameters.lowerJointLimit == 0.0 && parameters.upperJointLimit == 0.0)
+        {
+            // not reported by the controller
+            positions.lower[j] = -M_PI;
+            positions.upper[j] = M_PI;
+        }
+        else
+        {
+            positions.lower[j] = parameters.lowerJointLimit;
+            positions.upper[j] = parameters.upperJointLimit;
+        }
+
+        velocities.lower[j] = -parameters.maxVelocity;
+        velocities.upper[j] = parameters.maxVelocity;
     }
 
-    AMOR_JOINT_INFO parameters;
+    return {positions, velocities};
+}
+
+// -----------------------------------------------------------------------------
 
-    if (std::lock_guard lock(handleMutex); amor_get_joint_info(handle, axis, &parameters) != AMOR_SUCCESS)
+bool AmorControlBoard::enforceLimits(const SoftLimits & limits, AMOR_VECTOR7 & values, unsigned int mask, const char * what)
+{
+    const int j = limits.enforce(values, mask);
+
+    if (j == -1)
     {
-        yCError(ACB, "amor_get_joint_info() failed: %s", amor_error());
-        return false;
+        return true;
     }
 
-    *max = toDeg(parameters.maxVelocity);
-    *min = -(*max);
+    const auto range = limits.get();
 
-    return true;
+    // both positions and velocities are expressed in degrees on the client side
+    yCError(ACB, "Joint %d %s setpoint %f out of soft limits [%f, %f], command rejected",
+            j, what, toDeg(values[j]), toDeg(range.lower[j]), toDeg(range.upper[j]));
+
+    return false;
 }
 
 // -----------------------------------------------------------------------------
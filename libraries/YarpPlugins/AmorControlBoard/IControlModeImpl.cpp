@@ -2,6 +2,9 @@
 
 #include "AmorControlBoard.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 #include <yarp/os/Log.h>
 #include <yarp/os/Vocab.h>
 
@@ -9,6 +12,28 @@
 
 using namespace roboticslab;
 
+namespace
+{
+    // the AMOR API applies a single kind of setpoint to the whole arm, modes
+    // that share a setter may be mixed, see switchControlModes() for the
+    // exception of position and position direct with the trajectory generator
+    int setterFamily(int mode)
+    {
+        switch (mode)
+        {
+        case VOCAB_CM_POSITION:
+        case VOCAB_CM_POSITION_DIRECT:
+            return VOCAB_CM_POSITION;
+        case VOCAB_CM_VELOCITY:
+            return VOCAB_CM_VELOCITY;
+        case VOCAB_CM_CURRENT:
+            return VOCAB_CM_CURRENT;
+        default:
+            return 0; // not supported
+        }
+    }
+}
+
 // ------------------- IControlMode related ------------------------------------
 
 bool AmorControlBoard::getControlMode(int j, int *mode)
@@ -20,7 +45,7 @@ bool AmorControlBoard::getControlMode(int j, int *mode)
         return false;
     }
 
-    *mode = controlMode;
+    *mode = controlModes[j];
     return true;
 }
 
@@ -69,42 +94,187 @@ bool AmorControlBoard::setControlMode(const int j, const int mode)
         return false;
     }
 
-    controlMode = mode;
-
-    return true;
+    return switchControlModes(1, &j, &mode);
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::setControlModes(const int n_joint, const int *joints, int *modes)
 {
+    yCTrace(ACB, "%d", n_joint);
+
     if (!batchWithinRange(n_joint))
     {
         return false;
     }
 
-    bool ok = true;
-
-    for (unsigned int i = 0; i < n_joint; i++)
+    for (int i = 0; i < n_joint; i++)
     {
-        ok &= setControlMode(joints[i], modes[i]);
+        if (!indexWithinRange(joints[i]))
+        {
+            return false;
+        }
     }
 
-    return ok;
+    return switchControlModes(n_joint, joints, modes);
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::setControlModes(int *modes)
 {
-    bool ok = true;
+    yCTrace(ACB, "");
 
-    for (unsigned int i = 0; i < AMOR_NUM_JOINTS; i++)
+    int joints[AMOR_NUM_JOINTS];
+    std::iota(joints, joints + AMOR_NUM_JOINTS, 0);
+
+    return switchControlModes(AMOR_NUM_JOINTS, joints, modes);
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::checkControlMode(int mode, int n_joint, const int * joints)
+{
+    for (int i = 0; i < n_joint; i++)
     {
-        ok &= setControlMode(i, modes[i]);
+        if (!indexWithinRange(joints[i]))
+        {
+            return false;
+        }
+
+        if (controlModes[joints[i]] != mode)
+        {
+            yCError(ACB, "Joint %d is not in %s mode", joints[i], yarp::os::Vocab32::decode(mode).c_str());
+            return false;
+        }
     }
 
-    return ok;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::checkControlMode(int mode)
+{
+    int joints[AMOR_NUM_JOINTS];
+    std::iota(joints, joints + AMOR_NUM_JOINTS, 0);
+
+    return checkControlMode(mode, AMOR_NUM_JOINTS, joints);
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::switchControlModes(int n_joint, const int * joints, const int * modes)
+{
+    for (int i = 0; i < n_joint; i++)
+    {
+        if (setterFamily(modes[i]) == 0)
+        {
+            yCError(ACB, "Unsupported control mode for joint %d: %s", joints[i], yarp::os::Vocab32::decode(modes[i]).c_str());
+            return false;
+        }
+    }
+
+    std::lock_guard lock(controlModeMutex);
+
+    int next[AMOR_NUM_JOINTS];
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        next[j] = controlModes[j];
+    }
+
+    for (int i = 0; i < n_joint; i++)
+    {
+        next[joints[i]] = modes[i];
+    }
+
+    const int from = setterFamily(controlModes[0]);
+    const int to = setterFamily(next[0]);
+
+    for (int j = 1; j < AMOR_NUM_JOINTS; j++)
+    {
+        if (setterFamily(next[j]) != to)
+        {
+            yCError(ACB, "Joints %d and %d would be in %s and %s mode, the AMOR controller cannot mix them",
+                    0, j, yarp::os::Vocab32::decode(next[0]).c_str(), yarp::os::Vocab32::decode(next[j]).c_str());
+            return false;
+        }
+    }
+
+    // direct setpoints count as a new command and would abort the streamed
+    // trajectory of every joint in position mode
+    if (trajectoryGenerator
+            && std::find(next, next + AMOR_NUM_JOINTS, VOCAB_CM_POSITION) != next + AMOR_NUM_JOINTS
+            && std::find(next, next + AMOR_NUM_JOINTS, VOCAB_CM_POSITION_DIRECT) != next + AMOR_NUM_JOINTS)
+    {
+        yCError(ACB, "Position and position direct modes cannot be mixed while the trajectory generator is enabled (trajectoryPeriodMs)");
+        return false;
+    }
+
+    if (from != to)
+    {
+        if (!enterControlMode(to))
+        {
+            return false;
+        }
+    }
+    else if (trajectoryGenerator)
+    {
+        // joints leaving position mode must not be driven by the generator anymore
+        for (int i = 0; i < n_joint; i++)
+        {
+            if (controlModes[joints[i]] == VOCAB_CM_POSITION && modes[i] != VOCAB_CM_POSITION)
+            {
+                trajectoryGenerator->hold(1, &joints[i]);
+            }
+        }
+    }
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        controlModes[j] = next[j];
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::enterControlMode(int family)
+{
+    yCInfo(ACB, "Switching AMOR controller to %s control", yarp::os::Vocab32::decode(family).c_str());
+
+    if (trajectoryGenerator)
+    {
+        trajectoryGenerator->abort();
+    }
+
+    if (currentStreamer)
+    {
+        currentStreamer->disarm();
+    }
+
+    if (velocityWatchdog)
+    {
+        velocityWatchdog->disarm();
+    }
+
+    AMOR_VECTOR7 setpoints {};
+
+    switch (family)
+    {
+    case VOCAB_CM_POSITION:
+        // hold still where we are
+        return getActualPositions(setpoints) && sendPositions(__func__, setpoints);
+    case VOCAB_CM_VELOCITY:
+        return commandedVelocities.send(*bus, commandSource, __func__, setpoints);
+    case VOCAB_CM_CURRENT:
+        // keep the torque currently exerted on each joint
+        return getActualCurrents(setpoints) && commandedCurrents.send(*bus, commandSource, __func__, setpoints);
+    default:
+        return false;
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -30,9 +30,8 @@ bool AmorControlBoard::getCurrent(int m, double *curr)
 
     AMOR_VECTOR7 currents;
 
-    if (std::lock_guard lock(handleMutex); amor_get_actual_currents(handle, &currents) != AMOR_SUCCESS)
+    if (!getActualCurrents(currents))
     {
-        yCError(ACB, "amor_get_actual_currents() failed: %s", amor_error());
         return false;
     }
 
@@ -49,9 +48,8 @@ bool AmorControlBoard::getCurrents(double *currs)
 
     AMOR_VECTOR7 currents;
 
-    if (std::lock_guard lock(handleMutex); amor_get_actual_currents(handle, &currents) != AMOR_SUCCESS)
+    if (!getActualCurrents(currents))
     {
-        yCError(ACB, "amor_get_actual_currents() failed: %s", amor_error());
         return false;
     }
 
@@ -71,16 +69,10 @@ bool AmorControlBoard::getCurrentRange(int m, double *min, double *max)
         return false;
     }
 
-    AMOR_JOINT_INFO parameters;
+    const auto maxCurrent = jointInfo.load()[m].maxCurrent;
 
-    if (std::lock_guard lock(handleMutex); amor_get_joint_info(handle, m, &parameters) != AMOR_SUCCESS)
-    {
-        yCError(ACB, "amor_get_joint_info() failed: %s", amor_error());
-        return false;
-    }
-
-    *min = -parameters.maxCurrent;
-    *max = parameters.maxCurrent;
+    *min = -maxCurrent;
+    *max = maxCurrent;
 
     return true;
 }
@@ -91,14 +83,15 @@ bool AmorControlBoard::getCurrentRanges(double *min, double *max)
 {
     yCTrace(ACB, "");
 
-    bool ok = true;
+    const auto table = jointInfo.load();
 
     for (int j = 0; j < AMOR_NUM_JOINTS; j++)
     {
-        ok &= getCurrentRange(j, &min[j], &max[j]);
+        min[j] = -table[j].maxCurrent;
+        max[j] = table[j].maxCurrent;
     }
 
-    return ok;
+    return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -107,17 +100,21 @@ bool AmorControlBoard::setRefCurrents(const double *currs)
 {
     yCTrace(ACB, "");
 
-    AMOR_VECTOR7 currents;
-
-    std::copy(currs, currs + AMOR_NUM_JOINTS, currents);
-
-    if (std::lock_guard lock(handleMutex); amor_set_currents(handle, currents) != AMOR_SUCCESS)
+    if (!checkControlMode(VOCAB_CM_CURRENT))
     {
-        yCError(ACB, "amor_set_currents() failed: %s", amor_error());
         return false;
     }
 
-    return true;
+    if (currentStreamer)
+    {
+        return currentStreamer->update([currs](auto & currents) { std::copy(currs, currs + AMOR_NUM_JOINTS, currents); });
+    }
+
+    AMOR_VECTOR7 currents;
+
+    std::copy(currs, currs + AMOR_NUM_JOINTS, currents);
+
+    return commandedCurrents.send(*bus, commandSource, __func__, currents);
 }
 
 // -----------------------------------------------------------------------------
@@ -131,23 +128,19 @@ bool AmorControlBoard::setRefCurrent(int m, double curr)
         return false;
     }
 
-    AMOR_VECTOR7 currents;
-
-    if (std::lock_guard lock(handleMutex); amor_get_actual_currents(handle, &currents) != AMOR_SUCCESS)
+    if (!checkControlMode(VOCAB_CM_CURRENT, 1, &m))
     {
-        yCError(ACB, "amor_get_actual_currents() failed: %s", amor_error());
         return false;
     }
 
-    currents[m] = curr;
+    auto fn = [m, curr](auto & currents) { currents[m] = curr; };
 
-    if (std::lock_guard lock(handleMutex); amor_set_currents(handle, currents) != AMOR_SUCCESS)
+    if (currentStreamer)
     {
-        yCError(ACB, "amor_set_currents() failed: %s", amor_error());
-        return false;
+        return currentStreamer->update(fn);
     }
 
-    return true;
+    return commandedCurrents.update(*bus, commandSource, __func__, fn);
 }
 
 // -----------------------------------------------------------------------------
@@ -156,26 +149,30 @@ bool AmorControlBoard::setRefCurrents(const int n_motor, const int *motors, cons
 {
     yCTrace(ACB, "%d", n_motor);
 
-    AMOR_VECTOR7 currents;
-
-    if (std::lock_guard lock(handleMutex); amor_get_actual_currents(handle, &currents) != AMOR_SUCCESS)
+    if (!batchWithinRange(n_motor))
     {
-        yCError(ACB, "amor_get_actual_currents() failed: %s", amor_error());
         return false;
     }
 
-    for (int i = 0; i < n_motor; i++)
+    if (!checkControlMode(VOCAB_CM_CURRENT, n_motor, motors))
     {
-        currents[motors[i]] = currs[i];
+        return false;
     }
 
-    if (std::lock_guard lock(handleMutex); amor_set_currents(handle, currents) != AMOR_SUCCESS)
+    auto fn = [n_motor, motors, currs](auto & currents)
     {
-        yCError(ACB, "amor_set_currents() failed: %s", amor_error());
-        return false;
+        for (int i = 0; i < n_motor; i++)
+        {
+            currents[motors[i]] = currs[i];
+        }
+    };
+
+    if (currentStreamer)
+    {
+        return currentStreamer->update(fn);
     }
 
-    return true;
+    return commandedCurrents.update(*bus, commandSource, __func__, fn);
 }
 
 // -----------------------------------------------------------------------------
@@ -186,9 +183,8 @@ bool AmorControlBoard::getRefCurrents(double *currs)
 
     AMOR_VECTOR7 currents;
 
-    if (std::lock_guard lock(handleMutex); amor_get_req_currents(handle, &currents) != AMOR_SUCCESS)
+    if (!getCommandedCurrents(currents))
     {
-        yCError(ACB, "amor_get_req_currents() failed: %s", amor_error());
         return false;
     }
 
@@ -210,9 +206,8 @@ bool AmorControlBoard::getRefCurrent(int m, double *curr)
 
     AMOR_VECTOR7 currents;
 
-    if (std::lock_guard lock(handleMutex); amor_get_req_currents(handle, &currents) != AMOR_SUCCESS)
+    if (!getCommandedCurrents(currents))
     {
-        yCError(ACB, "amor_get_req_currents() failed: %s", amor_error());
         return false;
     }
 
@@ -222,3 +217,21 @@ bool AmorControlBoard::getRefCurrent(int m, double *curr)
 }
 
 // -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getCommandedCurrents(AMOR_VECTOR7 & currents)
+{
+    if (currentStreamer && currentStreamer->getReferences(currents))
+    {
+        return true;
+    }
+
+    if (bus->call(monitorSource, __func__, [&](AMOR_HANDLE handle) { return amor_get_req_currents(handle, &currents); }) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "amor_get_req_currents() failed: %s", AmorBus::lastError());
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
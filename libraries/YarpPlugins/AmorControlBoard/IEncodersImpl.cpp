@@ -53,9 +53,8 @@ bool AmorControlBoard::getEncoder(int j, double *v)
 
     AMOR_VECTOR7 positions;
 
-    if (std::lock_guard lock(handleMutex); amor_get_actual_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!getActualPositions(positions))
     {
-        yCError(ACB, "amor_get_actual_positions() failed: %s", amor_error());
         return false;
     }
 
@@ -72,9 +71,8 @@ bool AmorControlBoard::getEncoders(double *encs)
 
     AMOR_VECTOR7 positions;
 
-    if (std::lock_guard lock(handleMutex); amor_get_actual_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!getActualPositions(positions))
     {
-        yCError(ACB, "amor_get_actual_positions() failed: %s", amor_error());
         return false;
     }
 
@@ -99,9 +97,8 @@ bool AmorControlBoard::getEncoderSpeed(int j, double *sp)
 
     AMOR_VECTOR7 velocities;
 
-    if (std::lock_guard lock(handleMutex); amor_get_actual_velocities(handle, &velocities) != AMOR_SUCCESS)
+    if (!getActualVelocities(velocities))
     {
-        yCError(ACB, "amor_get_actual_velocities() failed: %s", amor_error());
         return false;
     }
 
@@ -118,9 +115,8 @@ bool AmorControlBoard::getEncoderSpeeds(double *spds)
 
     AMOR_VECTOR7 velocities;
 
-    if (std::lock_guard lock(handleMutex); amor_get_actual_velocities(handle, &velocities) != AMOR_SUCCESS)
+    if (!getActualVelocities(velocities))
     {
-        yCError(ACB, "amor_get_actual_velocities() failed: %s", amor_error());
         return false;
     }
 
@@ -136,16 +132,44 @@ bool AmorControlBoard::getEncoderSpeeds(double *spds)
 
 bool AmorControlBoard::getEncoderAcceleration(int j, double *spds)
 {
-    //yCError(ACB, "getEncoderAcceleration() not available");
-    return false;
+    yCTrace(ACB, "%d", j);
+
+    if (!statePoller)
+    {
+        //yCError(ACB, "getEncoderAcceleration() requires the state poller (--pollPeriodMs)");
+        return false;
+    }
+
+    if (!indexWithinRange(j))
+    {
+        return false;
+    }
+
+    *spds = toDeg(statePoller->getSample().accelerations[j]);
+
+    return true;
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::getEncoderAccelerations(double *accs)
 {
-    //yCError(ACB, "getEncoderAccelerations() not available");
-    return false;
+    yCTrace(ACB, "");
+
+    if (!statePoller)
+    {
+        //yCError(ACB, "getEncoderAccelerations() requires the state poller (--pollPeriodMs)");
+        return false;
+    }
+
+    const auto sample = statePoller->getSample();
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        accs[j] = toDeg(sample.accelerations[j]);
+    }
+
+    return true;
 }
 
 // ------------------ IEncodersTimed related -----------------------------------------
@@ -153,9 +177,22 @@ bool AmorControlBoard::getEncoderAccelerations(double *accs)
 bool AmorControlBoard::getEncodersTimed(double *encs, double *time)
 {
     yCTrace(ACB, "");
-    double now = yarp::os::Time::now();
-    std::fill_n(time, AMOR_NUM_JOINTS, now);
-    return getEncoders(encs);
+
+    AMOR_VECTOR7 positions;
+    double timestamp;
+
+    if (!getActualPositions(positions, &timestamp))
+    {
+        return false;
+    }
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        encs[j] = toDeg(positions[j]);
+        time[j] = timestamp;
+    }
+
+    return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -163,8 +200,22 @@ bool AmorControlBoard::getEncodersTimed(double *encs, double *time)
 bool AmorControlBoard::getEncoderTimed(int j, double *encs, double *time)
 {
     yCTrace(ACB, "%d", j);
-    *time = yarp::os::Time::now();
-    return getEncoder(j, encs);
+
+    if (!indexWithinRange(j))
+    {
+        return false;
+    }
+
+    AMOR_VECTOR7 positions;
+
+    if (!getActualPositions(positions, time))
+    {
+        return false;
+    }
+
+    *encs = toDeg(positions[j]);
+
+    return true;
 }
 
 // -----------------------------------------------------------------------------
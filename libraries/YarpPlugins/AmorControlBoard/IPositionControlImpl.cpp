@@ -2,7 +2,11 @@
 
 #include "AmorControlBoard.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 #include <yarp/os/Log.h>
+#include <yarp/os/Vocab.h>
 
 #include "LogComponent.hpp"
 
@@ -27,24 +31,32 @@ bool AmorControlBoard::positionMove(int j, double ref)
         return false;
     }
 
-    AMOR_VECTOR7 positions;
-
-    if (std::lock_guard lock(handleMutex); amor_get_actual_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!checkControlMode(VOCAB_CM_POSITION, 1, &j))
     {
-        yCError(ACB, "amor_get_actual_positions(): %s", amor_error());
         return false;
     }
 
-    positions[j] = toRad(ref);
+    AMOR_VECTOR7 limited {};
+    limited[j] = toRad(ref);
 
-    std::lock_guard lock(handleMutex);
-    return amor_set_positions(handle, positions) == AMOR_SUCCESS;
+    if (!enforceLimits(positionLimits, limited, 1u << j, "position"))
+    {
+        return false;
+    }
+
+    const double position = limited[j];
+    return moveTo(__func__, [j, position](auto & positions) { positions[j] = position; });
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::positionMove(const double *refs)
 {
+    if (!checkControlMode(VOCAB_CM_POSITION))
+    {
+        return false;
+    }
+
     AMOR_VECTOR7 positions;
 
     for (int j = 0; j < AMOR_NUM_JOINTS; j++)
@@ -52,8 +64,17 @@ bool AmorControlBoard::positionMove(const double *refs)
         positions[j] = toRad(refs[j]);
     }
 
-    std::lock_guard lock(handleMutex);
-    return amor_set_positions(handle, positions) == AMOR_SUCCESS;
+    if (!enforceLimits(positionLimits, positions, SoftLimits::ALL_JOINTS, "position"))
+    {
+        return false;
+    }
+
+    if (trajectoryGenerator)
+    {
+        return trajectoryGenerator->move([&positions](auto & targets) { std::copy(positions, positions + AMOR_NUM_JOINTS, targets); });
+    }
+
+    return sendPositions(__func__, positions);
 }
 
 // -----------------------------------------------------------------------------
@@ -67,45 +88,60 @@ bool AmorControlBoard::relativeMove(int j, double delta)
         return false;
     }
 
-    AMOR_VECTOR7 positions;
-
-    if (std::lock_guard lock(handleMutex); amor_get_actual_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!checkControlMode(VOCAB_CM_POSITION, 1, &j))
     {
-        yCError(ACB, "amor_get_actual_positions(): %s", amor_error());
         return false;
     }
 
-    positions[j] += toRad(delta);
-
-    std::lock_guard lock(handleMutex);
-    return amor_set_positions(handle, positions) == AMOR_SUCCESS;
+    // the resulting target is only known once the current one is, check it from within the edit
+    return moveTo(__func__, [this, j, delta](auto & positions)
+        {
+            positions[j] += toRad(delta);
+            return enforceLimits(positionLimits, positions, 1u << j, "position");
+        });
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::relativeMove(const double *deltas)
 {
-    AMOR_VECTOR7 positions;
-
-    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    if (!checkControlMode(VOCAB_CM_POSITION))
     {
-        positions[j] += toRad(deltas[j]);
+        return false;
     }
 
-    std::lock_guard lock(handleMutex);
-    return amor_set_positions(handle, positions) == AMOR_SUCCESS;
+    return moveTo(__func__, [this, deltas](auto & positions)
+        {
+            for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+            {
+                positions[j] += toRad(deltas[j]);
+            }
+
+            return enforceLimits(positionLimits, positions, SoftLimits::ALL_JOINTS, "position");
+        });
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::checkMotionDone(int j, bool *flag)
 {
+    yCTrace(ACB, "%d", j);
+
     if (!indexWithinRange(j))
     {
         return false;
     }
 
-    return checkMotionDone(flag);
+    bool flags[AMOR_NUM_JOINTS];
+
+    if (!getMotionDone(flags))
+    {
+        return false;
+    }
+
+    *flag = flags[j];
+
+    return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -114,15 +150,14 @@ bool AmorControlBoard::checkMotionDone(bool *flag)
 {
     yCTrace(ACB, "");
 
-    amor_movement_status status;
+    bool flags[AMOR_NUM_JOINTS];
 
-    if (std::lock_guard lock(handleMutex); amor_get_movement_status(handle, &status) != AMOR_SUCCESS)
+    if (!getMotionDone(flags))
     {
-        yCError(ACB, "amor_get_movement_status(): %s", amor_error());
         return false;
     }
 
-    *flag = (status == AMOR_MOVEMENT_STATUS_FINISHED);
+    *flag = std::all_of(flags, flags + AMOR_NUM_JOINTS, [](bool done) { return done; });
 
     return true;
 }
@@ -131,32 +166,60 @@ bool AmorControlBoard::checkMotionDone(bool *flag)
 
 bool AmorControlBoard::setRefSpeed(int j, double sp)
 {
-    yCError(ACB, "setRefSpeed() not available");
-    return false;
+    yCTrace(ACB, "%d %f", j, sp);
+
+    if (!indexWithinRange(j))
+    {
+        return false;
+    }
+
+    return applyRefSpeed(j, sp);
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::setRefSpeeds(const double *spds)
 {
-    yCError(ACB, "setRefSpeeds() not available");
-    return false;
+    yCTrace(ACB, "");
+
+    bool ok = true;
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        ok &= applyRefSpeed(j, spds[j]);
+    }
+
+    return ok;
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::setRefAcceleration(int j, double acc)
 {
-    yCError(ACB, "setRefAcceleration() not available");
-    return false;
+    yCTrace(ACB, "%d %f", j, acc);
+
+    if (!indexWithinRange(j))
+    {
+        return false;
+    }
+
+    return applyRefAcceleration(j, acc);
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::setRefAccelerations(const double *accs)
 {
-    yCError(ACB, "setRefAccelerations() not available");
-    return false;
+    yCTrace(ACB, "");
+
+    bool ok = true;
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        ok &= applyRefAcceleration(j, accs[j]);
+    }
+
+    return ok;
 }
 
 // -----------------------------------------------------------------------------
@@ -170,17 +233,7 @@ bool AmorControlBoard::getRefSpeed(int j, double *ref)
         return false;
     }
 
-    AMOR_JOINT_INFO parameters;
-
-    if (std::lock_guard lock(handleMutex); amor_get_joint_info(handle, j, &parameters) != AMOR_SUCCESS)
-    {
-        yCError(ACB, "amor_get_joint_info(): %s", amor_error());
-        return false;
-    }
-
-    *ref = toDeg(parameters.maxVelocity);
-
-    return true;
+    return getRefSpeeds(1, &j, ref);
 }
 
 // -----------------------------------------------------------------------------
@@ -189,20 +242,10 @@ bool AmorControlBoard::getRefSpeeds(double *spds)
 {
     yCTrace(ACB, "");
 
-    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
-    {
-        AMOR_JOINT_INFO parameters;
+    int joints[AMOR_NUM_JOINTS];
+    std::iota(joints, joints + AMOR_NUM_JOINTS, 0);
 
-        if (std::lock_guard lock(handleMutex); amor_get_joint_info(handle, j, &parameters) != AMOR_SUCCESS)
-        {
-            yCError(ACB, "amor_get_joint_info(): %s", amor_error());
-            return false;
-        }
-
-        spds[j] = toDeg(parameters.maxVelocity);
-    }
-
-    return true;
+    return getRefSpeeds(AMOR_NUM_JOINTS, joints, spds);
 }
 
 // -----------------------------------------------------------------------------
@@ -216,17 +259,7 @@ bool AmorControlBoard::getRefAcceleration(int j, double *acc)
         return false;
     }
 
-    AMOR_JOINT_INFO parameters;
-
-    if (std::lock_guard lock(handleMutex); amor_get_joint_info(handle, j, &parameters) != AMOR_SUCCESS)
-    {
-        yCError(ACB, "amor_get_joint_info(): %s", amor_error());
-        return false;
-    }
-
-    *acc = toDeg(parameters.maxAcceleration);
-
-    return true;
+    return getRefAccelerations(1, &j, acc);
 }
 
 // -----------------------------------------------------------------------------
@@ -235,34 +268,24 @@ bool AmorControlBoard::getRefAccelerations(double *accs)
 {
     yCTrace(ACB, "");
 
-    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
-    {
-        AMOR_JOINT_INFO parameters;
-
-        if (std::lock_guard lock(handleMutex); amor_get_joint_info(handle, j, &parameters) != AMOR_SUCCESS)
-        {
-            yCError(ACB, "amor_get_joint_info(): %s", amor_error());
-            return false;
-        }
-
-        accs[j] = toDeg(parameters.maxAcceleration);
-    }
+    int joints[AMOR_NUM_JOINTS];
+    std::iota(joints, joints + AMOR_NUM_JOINTS, 0);
 
-    return true;
+    return getRefAccelerations(AMOR_NUM_JOINTS, joints, accs);
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::stop(int j)
 {
-    yCWarning(ACB, "Selective stop not available, stopping all joints at once (%d)", j);
+    yCTrace(ACB, "%d", j);
 
     if (!indexWithinRange(j))
     {
         return false;
     }
 
-    return stop();
+    return stopJoints(1, &j);
 }
 
 // -----------------------------------------------------------------------------
@@ -270,8 +293,27 @@ bool AmorControlBoard::stop(int j)
 bool AmorControlBoard::stop()
 {
     yCTrace(ACB, "");
-    std::lock_guard lock(handleMutex);
-    return amor_controlled_stop(handle) == AMOR_SUCCESS;
+
+    if (trajectoryGenerator)
+    {
+        trajectoryGenerator->abort();
+    }
+
+    if (currentStreamer)
+    {
+        currentStreamer->disarm();
+    }
+
+    int joints[AMOR_NUM_JOINTS];
+    std::iota(joints, joints + AMOR_NUM_JOINTS, 0);
+    stopMonitor->request(AMOR_NUM_JOINTS, joints);
+
+    if (velocityWatchdog)
+    {
+        velocityWatchdog->disarm();
+    }
+
+    return bus->call(safetySource, __func__, [this](AMOR_HANDLE handle) { return controlledStop(handle); });
 }
 
 // -----------------------------------------------------------------------------
@@ -285,21 +327,32 @@ bool AmorControlBoard::positionMove(const int n_joint, const int *joints, const
         return false;
     }
 
-    AMOR_VECTOR7 positions;
-
-    if (std::lock_guard lock(handleMutex); n_joint < AMOR_NUM_JOINTS && amor_get_actual_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!checkControlMode(VOCAB_CM_POSITION, n_joint, joints))
     {
-        yCError(ACB, "amor_get_actual_positions(): %s", amor_error());
         return false;
     }
 
-    for (int j = 0; j < n_joint; j++)
+    AMOR_VECTOR7 limited {};
+    unsigned int mask = 0;
+
+    for (int i = 0; i < n_joint; i++)
     {
-        positions[joints[j]] = toRad(refs[j]);
+        limited[joints[i]] = toRad(refs[i]);
+        mask |= 1u << joints[i];
     }
 
-    std::lock_guard lock(handleMutex);
-    return amor_set_positions(handle, positions) == AMOR_SUCCESS;
+    if (!enforceLimits(positionLimits, limited, mask, "position"))
+    {
+        return false;
+    }
+
+    return moveTo(__func__, [n_joint, joints, &limited](auto & positions)
+        {
+            for (int i = 0; i < n_joint; i++)
+            {
+                positions[joints[i]] = limited[joints[i]];
+            }
+        });
 }
 
 // -----------------------------------------------------------------------------
@@ -313,21 +366,23 @@ bool AmorControlBoard::relativeMove(const int n_joint, const int *joints, const
         return false;
     }
 
-    AMOR_VECTOR7 positions;
-
-    if (std::lock_guard lock(handleMutex); n_joint < AMOR_NUM_JOINTS && amor_get_actual_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!checkControlMode(VOCAB_CM_POSITION, n_joint, joints))
     {
-        yCError(ACB, "amor_get_actual_positions(): %s", amor_error());
         return false;
     }
 
-    for (int j = 0; j < n_joint; j++)
-    {
-        positions[joints[j]] += toRad(deltas[j]);
-    }
+    return moveTo(__func__, [this, n_joint, joints, deltas](auto & positions)
+        {
+            unsigned int mask = 0;
 
-    std::lock_guard lock(handleMutex);
-    return amor_set_positions(handle, positions) == AMOR_SUCCESS;
+            for (int i = 0; i < n_joint; i++)
+            {
+                positions[joints[i]] += toRad(deltas[i]);
+                mask |= 1u << joints[i];
+            }
+
+            return enforceLimits(positionLimits, positions, mask, "position");
+        });
 }
 
 // -----------------------------------------------------------------------------
@@ -336,24 +391,21 @@ bool AmorControlBoard::checkMotionDone(const int n_joint, const int *joints, boo
 {
     yCTrace(ACB, "%d", n_joint);
 
-    if (!batchWithinRange(n_joint))
+    if (!batchWithinRange(n_joint, joints))
     {
         return false;
     }
 
-    amor_movement_status status;
+    bool done[AMOR_NUM_JOINTS];
 
-    if (std::lock_guard lock(handleMutex); amor_get_movement_status(handle, &status) != AMOR_SUCCESS)
+    if (!getMotionDone(done))
     {
-        yCError(ACB, "amor_get_movement_status(): %s", amor_error());
         return false;
     }
 
-    bool flag = (status == AMOR_MOVEMENT_STATUS_FINISHED);
-
     for (int j = 0; j < n_joint; j++)
     {
-        flags[j] = flag;
+        flags[j] = done[joints[j]];
     }
 
     return true;
@@ -363,16 +415,42 @@ bool AmorControlBoard::checkMotionDone(const int n_joint, const int *joints, boo
 
 bool AmorControlBoard::setRefSpeeds(const int n_joint, const int *joints, const double *spds)
 {
-    yCError(ACB, "setRefSpeeds() not available");
-    return false;
+    yCTrace(ACB, "%d", n_joint);
+
+    if (!batchWithinRange(n_joint, joints))
+    {
+        return false;
+    }
+
+    bool ok = true;
+
+    for (int j = 0; j < n_joint; j++)
+    {
+        ok &= applyRefSpeed(joints[j], spds[j]);
+    }
+
+    return ok;
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::setRefAccelerations(const int n_joint, const int *joints, const double *accs)
 {
-    yCError(ACB, "setRefAccelerations() not available");
-    return false;
+    yCTrace(ACB, "%d", n_joint);
+
+    if (!batchWithinRange(n_joint, joints))
+    {
+        return false;
+    }
+
+    bool ok = true;
+
+    for (int j = 0; j < n_joint; j++)
+    {
+        ok &= applyRefAcceleration(joints[j], accs[j]);
+    }
+
+    return ok;
 }
 
 // -----------------------------------------------------------------------------
@@ -381,22 +459,16 @@ bool AmorControlBoard::getRefSpeeds(const int n_joint, const int *joints, double
 {
     yCTrace(ACB, "%d", n_joint);
 
-    if (!batchWithinRange(n_joint))
+    if (!batchWithinRange(n_joint, joints))
     {
         return false;
     }
 
+    const auto table = jointInfo.load();
+
     for (int j = 0; j < n_joint; j++)
     {
-        AMOR_JOINT_INFO parameters;
-
-        if (std::lock_guard lock(handleMutex); amor_get_joint_info(handle, joints[j], &parameters) != AMOR_SUCCESS)
-        {
-            yCError(ACB, "amor_get_joint_info(): %s", amor_error());
-            return false;
-        }
-
-        spds[j] = toDeg(parameters.maxVelocity);
+        spds[j] = toDeg(trajectoryGenerator ? trajectoryGenerator->getRefSpeed(joints[j]) : table[joints[j]].maxVelocity);
     }
 
     return true;
@@ -408,22 +480,16 @@ bool AmorControlBoard::getRefAccelerations(const int n_joint, const int *joints,
 {
     yCTrace(ACB, "%d", n_joint);
 
-    if (!batchWithinRange(n_joint))
+    if (!batchWithinRange(n_joint, joints))
     {
         return false;
     }
 
+    const auto table = jointInfo.load();
+
     for (int j = 0; j < n_joint; j++)
     {
-        AMOR_JOINT_INFO parameters;
-
-        if (std::lock_guard lock(handleMutex); amor_get_joint_info(handle, joints[j], &parameters) != AMOR_SUCCESS)
-        {
-            yCError(ACB, "amor_get_joint_info(): %s", amor_error());
-            return false;
-        }
-
-        accs[j] = toDeg(parameters.maxAcceleration);
+        accs[j] = toDeg(trajectoryGenerator ? trajectoryGenerator->getRefAcceleration(joints[j]) : table[joints[j]].maxAcceleration);
     }
 
     return true;
@@ -433,14 +499,14 @@ bool AmorControlBoard::getRefAccelerations(const int n_joint, const int *joints,
 
 bool AmorControlBoard::stop(const int n_joint, const int *joints)
 {
-    yCWarning(ACB, "Selective stop not available, stopping all joints at once (%d)", n_joint);
+    yCTrace(ACB, "%d", n_joint);
 
     if (!batchWithinRange(n_joint))
     {
         return false;
     }
 
-    return stop();
+    return stopJoints(n_joint, joints);
 }
 
 // -----------------------------------------------------------------------------
@@ -456,9 +522,8 @@ bool AmorControlBoard::getTargetPosition(const int joint, double *ref)
 
     AMOR_VECTOR7 positions;
 
-    if (std::lock_guard lock(handleMutex); amor_get_req_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!getTargets(positions))
     {
-        yCError(ACB, "amor_get_req_positions(): %s", amor_error());
         return false;
     }
 
@@ -475,9 +540,8 @@ bool AmorControlBoard::getTargetPositions(double *refs)
 
     AMOR_VECTOR7 positions;
 
-    if (std::lock_guard lock(handleMutex); amor_get_req_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!getTargets(positions))
     {
-        yCError(ACB, "amor_get_req_positions(): %s", amor_error());
         return false;
     }
 
@@ -495,16 +559,15 @@ bool AmorControlBoard::getTargetPositions(const int n_joint, const int *joints,
 {
     yCTrace(ACB, "%d", n_joint);
 
-    if (!batchWithinRange(n_joint))
+    if (!batchWithinRange(n_joint, joints))
     {
         return false;
     }
 
     AMOR_VECTOR7 positions;
 
-    if (std::lock_guard lock(handleMutex); amor_get_req_positions(handle, &positions) != AMOR_SUCCESS)
+    if (!getTargets(positions))
     {
-        yCError(ACB, "amor_get_req_positions(): %s", amor_error());
         return false;
     }
 
@@ -517,3 +580,196 @@ bool AmorControlBoard::getTargetPositions(const int n_joint, const int *joints,
 }
 
 // -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getTargets(AMOR_VECTOR7 & positions)
+{
+    if (trajectoryGenerator && trajectoryGenerator->getTargets(positions))
+    {
+        return true;
+    }
+
+    if (bus->call(monitorSource, __func__, [&](AMOR_HANDLE handle) { return amor_get_req_positions(handle, &positions); }) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "amor_get_req_positions(): %s", AmorBus::lastError());
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::controlledStop(AMOR_HANDLE handle)
+{
+    // setpoints are no longer meaningful, query them again on next partial command
+    commandedPositions.invalidate();
+    commandedVelocities.invalidate();
+    commandedCurrents.invalidate();
+    motionTracker.clear();
+    commandCounter++;
+
+    if (amor_controlled_stop(handle) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "amor_controlled_stop() failed: %s", amor_error());
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::stopJoints(int n_joint, const int * joints)
+{
+    if (n_joint == 0)
+    {
+        return true;
+    }
+
+    if (!batchWithinRange(n_joint, joints))
+    {
+        return false;
+    }
+
+    // all joints share the same kind of setpoint, see switchControlModes()
+    const int mode = controlModes[joints[0]];
+
+    switch (mode)
+    {
+    case VOCAB_CM_VELOCITY:
+        stopMonitor->request(n_joint, joints);
+
+        return commandedVelocities.update(*bus, holdSource, __func__, [n_joint, joints](auto & velocities)
+            {
+                for (int i = 0; i < n_joint; i++)
+                {
+                    velocities[joints[i]] = 0.0;
+                }
+            });
+
+    case VOCAB_CM_POSITION:
+    case VOCAB_CM_POSITION_DIRECT:
+    {
+        stopMonitor->request(n_joint, joints);
+
+        // freeze the streamed profile if moving, otherwise hold the measured position
+        if (trajectoryGenerator && trajectoryGenerator->hold(n_joint, joints))
+        {
+            return true;
+        }
+
+        AMOR_VECTOR7 positions;
+
+        if (!getActualPositions(positions))
+        {
+            return false;
+        }
+
+        return commandPositions(holdSource, __func__, [n_joint, joints, &positions](auto & setpoints)
+            {
+                for (int i = 0; i < n_joint; i++)
+                {
+                    setpoints[joints[i]] = positions[joints[i]];
+                }
+            });
+    }
+
+    default:
+        yCWarning(ACB, "Selective stop not available in %s mode, stopping all joints at once",
+                  yarp::os::Vocab32::decode(mode).c_str());
+        return stop();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::sendPositions(const char * site, const AMOR_VECTOR7 & positions)
+{
+    return bus->call(commandSource, site, [this, &positions](AMOR_HANDLE handle)
+        {
+            if (!commandedPositions.write(handle, positions))
+            {
+                return false;
+            }
+
+            motionTracker.setTargets(positions);
+            return true;
+        });
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getMotionDone(bool * flags)
+{
+    bool pending[AMOR_NUM_JOINTS] {};
+
+    if (trajectoryGenerator && trajectoryGenerator->getPending(pending)
+            && std::all_of(pending, pending + AMOR_NUM_JOINTS, [](bool p) { return p; }))
+    {
+        std::fill(flags, flags + AMOR_NUM_JOINTS, false);
+        return true;
+    }
+
+    // served from the state poller's cache, if enabled
+    AMOR_VECTOR7 positions, velocities;
+
+    if (!getActualPositions(positions) || !getActualVelocities(velocities))
+    {
+        return false;
+    }
+
+    motionTracker.check(positions, velocities, flags);
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        flags[j] = flags[j] && !pending[j];
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::applyRefSpeed(int j, double sp)
+{
+    if (!trajectoryGenerator)
+    {
+        yCError(ACB, "Reference speeds not available, enable the trajectory generator (trajectoryPeriodMs)");
+        return false;
+    }
+
+    const double max = toDeg(jointInfo.load()[j].maxVelocity);
+
+    if (sp <= 0.0 || sp > max)
+    {
+        yCError(ACB, "Illegal reference speed for joint %d: %f (must be in range (0, %f] deg/s)", j, sp, max);
+        return false;
+    }
+
+    trajectoryGenerator->setRefSpeed(j, toRad(sp));
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::applyRefAcceleration(int j, double acc)
+{
+    if (!trajectoryGenerator)
+    {
+        yCError(ACB, "Reference accelerations not available, enable the trajectory generator (trajectoryPeriodMs)");
+        return false;
+    }
+
+    const double max = toDeg(jointInfo.load()[j].maxAcceleration);
+
+    if (acc <= 0.0 || acc > max)
+    {
+        yCError(ACB, "Illegal reference acceleration for joint %d: %f (must be in range (0, %f] deg/s^2)", j, acc, max);
+        return false;
+    }
+
+    trajectoryGenerator->setRefAcceleration(j, toRad(acc));
+    return true;
+}
+
+// -----------------------------------------------------------------------------
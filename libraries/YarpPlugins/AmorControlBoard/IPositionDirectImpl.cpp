@@ -0,0 +1,178 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "AmorControlBoard.hpp"
+
+#include <yarp/os/Log.h>
+
+#include "LogComponent.hpp"
+
+using namespace roboticslab;
+
+// ------------------- IPositionDirect related --------------------------------
+
+// Streaming setpoints are sent straight to amor_set_positions() through their
+// own high-priority bus source, so that they are not held back by queued
+// commands or state queries. Unit conversions happen before entering the bus
+// queue, and the setpoints of the remaining joints come from the command
+// shadow, so that no reads hit the bus on the steady-state path. Soft limits
+// are enforced beforehand too.
+
+bool AmorControlBoard::setPosition(int j, double ref)
+{
+    yCTrace(ACB, "%d %f", j, ref);
+
+    if (!indexWithinRange(j))
+    {
+        return false;
+    }
+
+    if (!checkControlMode(VOCAB_CM_POSITION_DIRECT, 1, &j))
+    {
+        return false;
+    }
+
+    AMOR_VECTOR7 limited {};
+    limited[j] = toRad(ref);
+
+    if (!enforceLimits(positionLimits, limited, 1u << j, "position"))
+    {
+        return false;
+    }
+
+    const double position = limited[j];
+    return commandedPositions.update(*bus, directSource, __func__, [j, position](auto & positions) { positions[j] = position; });
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::setPositions(const int n_joint, const int *joints, const double *refs)
+{
+    yCTrace(ACB, "%d", n_joint);
+
+    if (!batchWithinRange(n_joint, joints))
+    {
+        return false;
+    }
+
+    if (!checkControlMode(VOCAB_CM_POSITION_DIRECT, n_joint, joints))
+    {
+        return false;
+    }
+
+    AMOR_VECTOR7 positions {};
+    unsigned int mask = 0;
+
+    for (int i = 0; i < n_joint; i++)
+    {
+        positions[joints[i]] = toRad(refs[i]);
+        mask |= 1u << joints[i];
+    }
+
+    if (!enforceLimits(positionLimits, positions, mask, "position"))
+    {
+        return false;
+    }
+
+    return commandedPositions.update(*bus, directSource, __func__, [n_joint, joints, &positions](auto & setpoints)
+        {
+            for (int i = 0; i < n_joint; i++)
+            {
+                setpoints[joints[i]] = positions[joints[i]];
+            }
+        });
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::setPositions(const double *refs)
+{
+    if (!checkControlMode(VOCAB_CM_POSITION_DIRECT))
+    {
+        return false;
+    }
+
+    AMOR_VECTOR7 positions;
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        positions[j] = toRad(refs[j]);
+    }
+
+    if (!enforceLimits(positionLimits, positions, SoftLimits::ALL_JOINTS, "position"))
+    {
+        return false;
+    }
+
+    return commandedPositions.send(*bus, directSource, __func__, positions);
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getRefPosition(const int joint, double *ref)
+{
+    yCTrace(ACB, "%d", joint);
+
+    if (!indexWithinRange(joint))
+    {
+        return false;
+    }
+
+    AMOR_VECTOR7 positions;
+
+    if (!commandedPositions.read(*bus, monitorSource, __func__, positions))
+    {
+        return false;
+    }
+
+    *ref = toDeg(positions[joint]);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getRefPositions(double *refs)
+{
+    yCTrace(ACB, "");
+
+    AMOR_VECTOR7 positions;
+
+    if (!commandedPositions.read(*bus, monitorSource, __func__, positions))
+    {
+        return false;
+    }
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        refs[j] = toDeg(positions[j]);
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getRefPositions(const int n_joint, const int *joints, double *refs)
+{
+    yCTrace(ACB, "%d", n_joint);
+
+    if (!batchWithinRange(n_joint, joints))
+    {
+        return false;
+    }
+
+    AMOR_VECTOR7 positions;
+
+    if (!commandedPositions.read(*bus, monitorSource, __func__, positions))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < n_joint; i++)
+    {
+        refs[i] = toDeg(positions[joints[i]]);
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
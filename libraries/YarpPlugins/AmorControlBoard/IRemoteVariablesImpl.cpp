@@ -0,0 +1,184 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "AmorControlBoard.hpp"
+
+#include <vector>
+
+#include <yarp/os/Log.h>
+
+#include "LogComponent.hpp"
+
+using namespace roboticslab;
+
+namespace
+{
+    // one list per call site or source, durations in seconds
+    void addBusStats(yarp::os::Bottle & val, const std::vector<CallSiteStats::Site> & stats)
+    {
+        for (const auto & s : stats)
+        {
+            auto & site = val.addList();
+            site.addString(s.site);
+            site.addInt64(s.service.count);
+            site.addInt64(s.coalesced);
+            site.addInt64(s.preempted);
+            site.addFloat64(s.wait.p50);
+            site.addFloat64(s.wait.p99);
+            site.addFloat64(s.wait.max);
+            site.addFloat64(s.wait.total);
+            site.addFloat64(s.service.p50);
+            site.addFloat64(s.service.p99);
+            site.addFloat64(s.service.max);
+            site.addFloat64(s.service.total);
+        }
+    }
+}
+
+// ------------------- IRemoteVariables related ------------------------------------
+
+bool AmorControlBoard::getRemoteVariable(std::string key, yarp::os::Bottle& val)
+{
+    yCTrace(ACB, "%s", key.c_str());
+
+    if (key == "encoderLatency")
+    {
+        val.addFloat64(statePoller ? statePoller->getSample().latency : encoderLatency.load());
+        return true;
+    }
+
+    if (key == "busStats")
+    {
+        addBusStats(val, bus->getStats());
+        return true;
+    }
+
+    if (key == "busSources")
+    {
+        addBusStats(val, bus->getSourceStats());
+        return true;
+    }
+
+    if (key == "setpointFilter")
+    {
+        // sent versus suppressed frames per control mode
+        for (const auto & [mode, shadow] : {std::make_pair("position", &commandedPositions),
+                                            std::make_pair("velocity", &commandedVelocities),
+                                            std::make_pair("current", &commandedCurrents)})
+        {
+            auto & entry = val.addList();
+            entry.addString(mode);
+            entry.addInt64(shadow->getFilter().getSent());
+            entry.addInt64(shadow->getFilter().getSuppressed());
+        }
+
+        return true;
+    }
+
+    if (key == "stopLatency")
+    {
+        // per joint: completed stops, timeouts, last, mean and max latency [s]
+        for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+        {
+            const auto stats = stopMonitor->getStats(j);
+            auto & entry = val.addList();
+            entry.addInt32(j);
+            entry.addInt64(stats.count);
+            entry.addInt64(stats.timeouts);
+            entry.addFloat64(stats.last);
+            entry.addFloat64(stats.mean);
+            entry.addFloat64(stats.max);
+        }
+
+        return true;
+    }
+
+    if (key == "currentStream" && currentStreamer)
+    {
+        // cycles, overruns, watchdog trips, mean and max jitter [s]
+        const auto stats = currentStreamer->getStats();
+        val.addInt64(stats.cycles);
+        val.addInt64(stats.overruns);
+        val.addInt64(stats.timeouts);
+        val.addFloat64(stats.meanJitter);
+        val.addFloat64(stats.maxJitter);
+        return true;
+    }
+
+    if (key == "startupTimings")
+    {
+        for (const auto & [phase, elapsed] : startupTimings)
+        {
+            auto & entry = val.addList();
+            entry.addString(phase);
+            entry.addFloat64(elapsed);
+        }
+
+        return true;
+    }
+
+    yCError(ACB, "Unsupported remote variable: %s", key.c_str());
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::setRemoteVariable(std::string key, const yarp::os::Bottle& val)
+{
+    yCTrace(ACB, "%s", key.c_str());
+
+    if (key == "busStats" || key == "busSources")
+    {
+        // any value clears both call site and source statistics
+        bus->resetStats();
+        return true;
+    }
+
+    if (key == "setpointFilter")
+    {
+        // any value clears the counters
+        commandedPositions.getFilter().resetCounters();
+        commandedVelocities.getFilter().resetCounters();
+        commandedCurrents.getFilter().resetCounters();
+        return true;
+    }
+
+    if (key == "stopLatency")
+    {
+        // any value clears the statistics
+        stopMonitor->resetStats();
+        return true;
+    }
+
+    if (key == "currentStream" && currentStreamer)
+    {
+        // any value clears the statistics
+        currentStreamer->resetStats();
+        return true;
+    }
+
+    yCError(ACB, "Remote variable %s is read-only or not supported", key.c_str());
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorControlBoard::getRemoteVariablesList(yarp::os::Bottle* listOfKeys)
+{
+    yCTrace(ACB, "");
+    listOfKeys->clear();
+    listOfKeys->addString("encoderLatency");
+    listOfKeys->addString("busStats");
+    listOfKeys->addString("busSources");
+    listOfKeys->addString("setpointFilter");
+    listOfKeys->addString("stopLatency");
+    listOfKeys->addString("startupTimings");
+
+    if (currentStreamer)
+    {
+        listOfKeys->addString("currentStream");
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
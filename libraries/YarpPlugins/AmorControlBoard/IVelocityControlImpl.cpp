@@ -19,24 +19,39 @@ bool AmorControlBoard::velocityMove(int j, double sp)
         return false;
     }
 
-    AMOR_VECTOR7 velocities;
+    if (!checkControlMode(VOCAB_CM_VELOCITY, 1, &j))
+    {
+        return false;
+    }
+
+    AMOR_VECTOR7 limited {};
+    limited[j] = toRad(sp);
 
-    if (std::lock_guard lock(handleMutex); amor_get_actual_velocities(handle, &velocities) != AMOR_SUCCESS)
+    if (!enforceLimits(velocityLimits, limited, 1u << j, "velocity"))
     {
-        yCError(ACB, "amor_get_actual_velocities() failed: %s", amor_error());
         return false;
     }
 
-    velocities[j] = toRad(sp);
+    const double velocity = limited[j];
 
-    std::lock_guard lock(handleMutex);
-    return amor_set_velocities(handle, velocities) == AMOR_SUCCESS;
+    if (!commandedVelocities.update(*bus, commandSource, __func__, [j, velocity](auto & velocities) { velocities[j] = velocity; }))
+    {
+        return false;
+    }
+
+    feedVelocityWatchdog();
+    return true;
 }
 
 // -----------------------------------------------------------------------------
 
 bool AmorControlBoard::velocityMove(const double *sp)
 {
+    if (!checkControlMode(VOCAB_CM_VELOCITY))
+    {
+        return false;
+    }
+
     AMOR_VECTOR7 velocities;
 
     for (int j = 0; j < AMOR_NUM_JOINTS; j++)
@@ -44,8 +59,18 @@ bool AmorControlBoard::velocityMove(const double *sp)
         velocities[j] = toRad(sp[j]);
     }
 
-    std::lock_guard lock(handleMutex);
-    return amor_set_velocities(handle, velocities) == AMOR_SUCCESS;
+    if (!enforceLimits(velocityLimits, velocities, SoftLimits::ALL_JOINTS, "velocity"))
+    {
+        return false;
+    }
+
+    if (!commandedVelocities.send(*bus, commandSource, __func__, velocities))
+    {
+        return false;
+    }
+
+    feedVelocityWatchdog();
+    return true;
 }
 
 // ----------------------------------------------------------------------------
@@ -59,21 +84,40 @@ bool AmorControlBoard::velocityMove(const int n_joint, const int *joints, const
         return false;
     }
 
-    AMOR_VECTOR7 velocities;
+    if (!checkControlMode(VOCAB_CM_VELOCITY, n_joint, joints))
+    {
+        return false;
+    }
+
+    AMOR_VECTOR7 limited {};
+    unsigned int mask = 0;
 
-    if (std::lock_guard lock(handleMutex); n_joint < AMOR_NUM_JOINTS && amor_get_actual_velocities(handle, &velocities) != AMOR_SUCCESS)
+    for (int i = 0; i < n_joint; i++)
+    {
+        limited[joints[i]] = toRad(spds[i]);
+        mask |= 1u << joints[i];
+    }
+
+    if (!enforceLimits(velocityLimits, limited, mask, "velocity"))
     {
-        yCError(ACB, "amor_get_actual_velocities() failed: %s", amor_error());
         return false;
     }
 
-    for (int j = 0; j < n_joint; j++)
+    bool ok = commandedVelocities.update(*bus, commandSource, __func__, [n_joint, joints, &limited](auto & velocities)
+        {
+            for (int i = 0; i < n_joint; i++)
+            {
+                velocities[joints[i]] = limited[joints[i]];
+            }
+        });
+
+    if (!ok)
     {
-        velocities[joints[j]] = toRad(spds[j]);
+        return false;
     }
 
-    std::lock_guard lock(handleMutex);
-    return amor_set_velocities(handle, velocities) == AMOR_SUCCESS;
+    feedVelocityWatchdog();
+    return true;
 }
 
 // -----------------------------------------------------------------------------
@@ -89,9 +133,9 @@ bool AmorControlBoard::getRefVelocity(const int joint, double *vel)
 
     AMOR_VECTOR7 velocities;
 
-    if (std::lock_guard lock(handleMutex); amor_get_req_velocities(handle, &velocities) != AMOR_SUCCESS)
+    if (bus->call(monitorSource, __func__, [&](AMOR_HANDLE handle) { return amor_get_req_velocities(handle, &velocities); }) != AMOR_SUCCESS)
     {
-        yCError(ACB, "amor_get_req_velocities() failed: %s", amor_error());
+        yCError(ACB, "amor_get_req_velocities() failed: %s", AmorBus::lastError());
         return false;
     }
 
@@ -108,9 +152,9 @@ bool AmorControlBoard::getRefVelocities(double *vels)
 
     AMOR_VECTOR7 velocities;
 
-    if (std::lock_guard lock(handleMutex); amor_get_req_velocities(handle, &velocities) != AMOR_SUCCESS)
+    if (bus->call(monitorSource, __func__, [&](AMOR_HANDLE handle) { return amor_get_req_velocities(handle, &velocities); }) != AMOR_SUCCESS)
     {
-        yCError(ACB, "amor_get_req_velocities() failed: %s", amor_error());
+        yCError(ACB, "amor_get_req_velocities() failed: %s", AmorBus::lastError());
         return false;
     }
 
@@ -128,16 +172,16 @@ bool AmorControlBoard::getRefVelocities(const int n_joint, const int *joints, do
 {
     yCTrace(ACB, "%d", n_joint);
 
-    if (!batchWithinRange(n_joint))
+    if (!batchWithinRange(n_joint, joints))
     {
         return false;
     }
 
     AMOR_VECTOR7 velocities;
 
-    if (std::lock_guard lock(handleMutex); amor_get_req_velocities(handle, &velocities) != AMOR_SUCCESS)
+    if (bus->call(monitorSource, __func__, [&](AMOR_HANDLE handle) { return amor_get_req_velocities(handle, &velocities); }) != AMOR_SUCCESS)
     {
-        yCError(ACB, "amor_get_req_velocities() failed: %s", amor_error());
+        yCError(ACB, "amor_get_req_velocities() failed: %s", AmorBus::lastError());
         return false;
     }
 
@@ -150,3 +194,13 @@ bool AmorControlBoard::getRefVelocities(const int n_joint, const int *joints, do
 }
 
 // -----------------------------------------------------------------------------
+
+void AmorControlBoard::feedVelocityWatchdog()
+{
+    if (velocityWatchdog)
+    {
+        velocityWatchdog->kick(velocityTimeout);
+    }
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,51 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "MotionTracker.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+void MotionTracker::configure(double positionTolerance, double velocityTolerance)
+{
+    this->positionTolerance = positionTolerance;
+    this->velocityTolerance = velocityTolerance;
+}
+
+// -----------------------------------------------------------------------------
+
+void MotionTracker::setTargets(const AMOR_VECTOR7 & targets)
+{
+    Record r;
+    std::copy(targets, targets + AMOR_NUM_JOINTS, r.targets);
+    r.epoch = commandCounter;
+    r.valid = true;
+    record.store(r);
+}
+
+// -----------------------------------------------------------------------------
+
+void MotionTracker::clear()
+{
+    record.store(Record {});
+}
+
+// -----------------------------------------------------------------------------
+
+void MotionTracker::check(const AMOR_VECTOR7 & positions, const AMOR_VECTOR7 & velocities, bool * flags) const
+{
+    const auto r = record.load();
+    const bool valid = r.valid && r.epoch == commandCounter;
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        flags[j] = std::abs(velocities[j]) <= velocityTolerance
+                && (!valid || std::abs(positions[j] - r.targets[j]) <= positionTolerance);
+    }
+}
+
+// -----------------------------------------------------------------------------
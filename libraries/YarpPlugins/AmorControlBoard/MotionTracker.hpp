@@ -0,0 +1,62 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_MOTION_TRACKER_HPP__
+#define __AMOR_MOTION_TRACKER_HPP__
+
+#include <atomic>
+
+#include <amor.h>
+
+#include "SeqLock.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Per-joint motion-done detection from measured joint state.
+ *
+ * Keeps the targets of the last position command, which remain valid until
+ * any other command reaches the arm (as signaled by the shared command
+ * counter). A joint is done once it has settled within the configured
+ * tolerances of its target; if no valid target is known, it is done as soon
+ * as it comes to rest. Targets are recorded from the bus I/O thread right
+ * after the command is sent and may be queried from any thread. Tolerances
+ * are expressed in SI units.
+ */
+class MotionTracker
+{
+public:
+    MotionTracker(const std::atomic<unsigned int> & commandCounter)
+        : commandCounter(commandCounter)
+    {}
+
+    //! Set position [rad] and velocity [rad/s] tolerances, must be called before use.
+    void configure(double positionTolerance, double velocityTolerance);
+
+    //! Record the targets of the last position command, must be called from within the bus request that sent it.
+    void setTargets(const AMOR_VECTOR7 & targets);
+
+    //! Forget the targets, must be called from within a bus request.
+    void clear();
+
+    //! Compute done flags for all joints given their measured positions and velocities.
+    void check(const AMOR_VECTOR7 & positions, const AMOR_VECTOR7 & velocities, bool * flags) const;
+
+private:
+    struct Record
+    {
+        AMOR_VECTOR7 targets;
+        unsigned int epoch;
+        bool valid;
+    };
+
+    const std::atomic<unsigned int> & commandCounter;
+    SeqLock<Record> record;
+    double positionTolerance {0.0};
+    double velocityTolerance {0.0};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_MOTION_TRACKER_HPP__
@@ -0,0 +1,86 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_SEQ_LOCK_HPP__
+#define __AMOR_SEQ_LOCK_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Single-writer, multiple-reader sequence lock.
+ *
+ * Readers never block the writer nor each other; instead, they retry
+ * whenever a concurrent store is detected. The payload is kept in atomic
+ * words so that torn reads are well-defined (and discarded).
+ */
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock()
+    {
+        store(T {});
+    }
+
+    //! Publish a new value, must be called from a single writer thread.
+    void store(const T & value)
+    {
+        std::array<std::uint64_t, WORDS> words {};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed); // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < WORDS; i++)
+        {
+            buffer[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        sequence.store(seq + 2, std::memory_order_release); // even: stable
+    }
+
+    //! Retrieve the last published value, safe to call from any thread.
+    T load() const
+    {
+        std::array<std::uint64_t, WORDS> words;
+        unsigned int seq0, seq1;
+
+        do
+        {
+            seq0 = sequence.load(std::memory_order_acquire);
+
+            for (std::size_t i = 0; i < WORDS; i++)
+            {
+                words[i] = buffer[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            seq1 = sequence.load(std::memory_order_relaxed);
+        }
+        while ((seq0 & 1) != 0 || seq0 != seq1);
+
+        T value;
+        std::memcpy(&value, words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<unsigned int> sequence {0};
+    std::array<std::atomic<std::uint64_t>, WORDS> buffer {};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_SEQ_LOCK_HPP__
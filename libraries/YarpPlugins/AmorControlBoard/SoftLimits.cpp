@@ -0,0 +1,85 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "SoftLimits.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+void SoftLimits::reset(const Range & range)
+{
+    std::lock_guard lock(writeMutex);
+    table.store(range);
+}
+
+// -----------------------------------------------------------------------------
+
+void SoftLimits::set(int j, double lower, double upper)
+{
+    std::lock_guard lock(writeMutex);
+    auto range = table.load();
+    range.lower[j] = lower;
+    range.upper[j] = upper;
+    table.store(range);
+}
+
+// -----------------------------------------------------------------------------
+
+int SoftLimits::enforce(AMOR_VECTOR7 & values, unsigned int mask) const
+{
+    const auto range = table.load();
+    unsigned int violations = 0;
+    unsigned int nans = 0;
+
+    // branch-free over the whole vector, the common case is a single pass with no hits
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        // written so that NaN counts as outside
+        const bool inside = (values[j] >= range.lower[j]) & (values[j] <= range.upper[j]);
+        const bool invalid = std::isnan(values[j]);
+        violations |= static_cast<unsigned int>(!inside) << j;
+        nans |= static_cast<unsigned int>(invalid) << j;
+    }
+
+    violations &= mask;
+    nans &= mask;
+
+    if (violations == 0)
+    {
+        return -1;
+    }
+
+    // NaN cannot be clamped into range
+    if (clamping && nans == 0)
+    {
+        for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+        {
+            if (violations & (1u << j))
+            {
+                values[j] = std::clamp(values[j], range.lower[j], range.upper[j]);
+            }
+        }
+
+        return -1;
+    }
+
+    if (clamping)
+    {
+        violations = nans;
+    }
+
+    int first = 0;
+
+    while ((violations & (1u << first)) == 0)
+    {
+        first++;
+    }
+
+    return first;
+}
+
+// -----------------------------------------------------------------------------
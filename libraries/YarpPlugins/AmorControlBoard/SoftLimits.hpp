@@ -0,0 +1,70 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_SOFT_LIMITS_HPP__
+#define __AMOR_SOFT_LIMITS_HPP__
+
+#include <mutex>
+
+#include <amor.h>
+
+#include "SeqLock.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Per-joint lower and upper bounds enforced on outgoing setpoints.
+ *
+ * Setpoints are checked (or clamped) locally in a single pass over the joint
+ * vector, before a request is even queued on the bus. Only the elements
+ * selected by a bit mask are inspected, so that partial commands are not
+ * held back by the setpoints of the remaining joints. Bounds are read
+ * lock-free and may be updated from any thread.
+ */
+class SoftLimits
+{
+public:
+    //! One bit per joint.
+    static constexpr unsigned int ALL_JOINTS = (1u << AMOR_NUM_JOINTS) - 1;
+
+    struct Range
+    {
+        AMOR_VECTOR7 lower;
+        AMOR_VECTOR7 upper;
+    };
+
+    //! Clamp out-of-range elements instead of rejecting the whole command.
+    void setClamping(bool enabled)
+    { clamping = enabled; }
+
+    bool isClamping() const
+    { return clamping; }
+
+    //! Replace all bounds.
+    void reset(const Range & range);
+
+    //! Update the bounds of a single joint.
+    void set(int j, double lower, double upper);
+
+    Range get() const
+    { return table.load(); }
+
+    /**
+     * Check the selected elements against the bounds, clamping them if enabled.
+     * @param values setpoint vector, modified only if clamping.
+     * @param mask selected joints, bit j set for joint j.
+     * @return index of the first offending joint, or -1 if none (or clamped). NaN
+     * elements are always out of range, and are not clamped.
+     */
+    int enforce(AMOR_VECTOR7 & values, unsigned int mask) const;
+
+private:
+    bool clamping {false};
+    std::mutex writeMutex;
+    SeqLock<Range> table;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_SOFT_LIMITS_HPP__
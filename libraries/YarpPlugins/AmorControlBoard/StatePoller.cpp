@@ -0,0 +1,82 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "StatePoller.hpp"
+
+#include <algorithm>
+
+#include <yarp/os/Log.h>
+#include <yarp/os/Time.h>
+
+#include "LogComponent.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+bool StatePoller::threadInit()
+{
+    // make sure a valid sample is available as soon as start() returns
+    return acquire();
+}
+
+// -----------------------------------------------------------------------------
+
+void StatePoller::run()
+{
+    acquire();
+}
+
+// -----------------------------------------------------------------------------
+
+bool StatePoller::acquire()
+{
+    Sample sample;
+
+    // a single request keeps the three reads together on the bus
+    bool ok = bus.call(origin, "StatePoller", [&sample](AMOR_HANDLE handle)
+        {
+            double start = yarp::os::Time::now();
+            AMOR_RESULT res = amor_get_actual_positions(handle, &sample.positions);
+            double end = yarp::os::Time::now();
+
+            if (res != AMOR_SUCCESS)
+            {
+                yCError(ACB, "amor_get_actual_positions() failed: %s", amor_error());
+                return false;
+            }
+
+            sample.timestamp = (start + end) / 2.0;
+            sample.latency = end - start;
+
+            if (amor_get_actual_velocities(handle, &sample.velocities) != AMOR_SUCCESS)
+            {
+                yCError(ACB, "amor_get_actual_velocities() failed: %s", amor_error());
+                return false;
+            }
+
+            if (amor_get_actual_currents(handle, &sample.currents) != AMOR_SUCCESS)
+            {
+                yCError(ACB, "amor_get_actual_currents() failed: %s", amor_error());
+                return false;
+            }
+
+            return true;
+        });
+
+    if (!ok)
+    {
+        return false;
+    }
+
+    history.push(sample.timestamp, sample.positions, sample.velocities);
+
+    if (!history.estimateAccelerations(sample.accelerations))
+    {
+        std::fill(sample.accelerations, sample.accelerations + AMOR_NUM_JOINTS, 0.0);
+    }
+
+    snapshot.store(sample);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
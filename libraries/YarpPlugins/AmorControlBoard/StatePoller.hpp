@@ -0,0 +1,66 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_STATE_POLLER_HPP__
+#define __AMOR_STATE_POLLER_HPP__
+
+#include <yarp/os/PeriodicThread.h>
+
+#include <amor.h>
+
+#include "AmorBus.hpp"
+#include "EncoderHistory.hpp"
+#include "SeqLock.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Periodically acquires joint state from the AMOR controller.
+ *
+ * Positions, velocities and currents are read once per cycle within a
+ * single bus request and published through a sequence lock, hence
+ * consumers can retrieve the latest sample without hitting the CAN bus.
+ * Joint accelerations are estimated from a history of past samples.
+ */
+class StatePoller : public yarp::os::PeriodicThread
+{
+public:
+    //! Joint state as reported by the AMOR API (SI units, currents in mA).
+    struct Sample
+    {
+        AMOR_VECTOR7 positions;
+        AMOR_VECTOR7 velocities;
+        AMOR_VECTOR7 currents;
+        AMOR_VECTOR7 accelerations; //!< estimated, zero until enough samples are collected
+        double timestamp; //!< midpoint of the position read call [s]
+        double latency; //!< duration of the position read call [s]
+    };
+
+    StatePoller(AmorBus & bus, const AmorBus::source & origin, double period, std::size_t accelerationWindow)
+        : yarp::os::PeriodicThread(period),
+          bus(bus),
+          origin(origin),
+          history(accelerationWindow)
+    {}
+
+    //! Retrieve the latest sample, never blocks.
+    Sample getSample() const
+    { return snapshot.load(); }
+
+protected:
+    bool threadInit() override;
+    void run() override;
+
+private:
+    bool acquire();
+
+    AmorBus & bus;
+    const AmorBus::source origin;
+    EncoderHistory history;
+    SeqLock<Sample> snapshot;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_STATE_POLLER_HPP__
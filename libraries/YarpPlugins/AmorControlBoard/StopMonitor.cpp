@@ -0,0 +1,124 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "StopMonitor.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+#include <yarp/os/Log.h>
+#include <yarp/os/Time.h>
+
+#include "LogComponent.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+void StopMonitor::request(int n_joint, const int * joints)
+{
+    const double now = yarp::os::Time::now();
+    std::lock_guard lock(mutex);
+
+    for (int i = 0; i < n_joint; i++)
+    {
+        // keep timing from the first request if the joint was already stopping
+        if (requested[joints[i]] == 0.0)
+        {
+            requested[joints[i]] = now;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+StopMonitor::Stats StopMonitor::getStats(int j) const
+{
+    std::lock_guard lock(mutex);
+    return stats[j];
+}
+
+// -----------------------------------------------------------------------------
+
+void StopMonitor::resetStats()
+{
+    std::lock_guard lock(mutex);
+    std::fill(stats, stats + AMOR_NUM_JOINTS, Stats {});
+    std::fill(total, total + AMOR_NUM_JOINTS, 0.0);
+}
+
+// -----------------------------------------------------------------------------
+
+void StopMonitor::run()
+{
+    {
+        std::lock_guard lock(mutex);
+
+        if (std::all_of(requested, requested + AMOR_NUM_JOINTS, [](double t) { return t == 0.0; }))
+        {
+            return;
+        }
+    }
+
+    AMOR_VECTOR7 velocities;
+
+    if (!getVelocities(velocities))
+    {
+        return;
+    }
+
+    const double now = yarp::os::Time::now();
+    std::lock_guard lock(mutex);
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        if (requested[j] == 0.0)
+        {
+            continue;
+        }
+
+        const double elapsed = now - requested[j];
+        auto & s = stats[j];
+
+        if (std::abs(velocities[j]) <= velocityTolerance)
+        {
+            s.count++;
+            s.last = elapsed;
+            s.max = std::max(s.max, elapsed);
+            total[j] += elapsed;
+            s.mean = total[j] / s.count;
+            requested[j] = 0.0;
+
+            yCDebug(ACB, "Joint %d stopped in %f s", j, elapsed);
+        }
+        else if (elapsed > TIMEOUT)
+        {
+            s.timeouts++;
+            requested[j] = 0.0;
+
+            yCWarning(ACB, "Joint %d did not come to rest %f s after stop request", j, elapsed);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool StopMonitor::getVelocities(AMOR_VECTOR7 & velocities)
+{
+    if (poller)
+    {
+        const auto sample = poller->getSample();
+        std::copy(sample.velocities, sample.velocities + AMOR_NUM_JOINTS, velocities);
+        return true;
+    }
+
+    if (bus.read(origin, "StopMonitor", AmorBus::read_kind::ACTUAL_VELOCITIES, velocities) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "amor_get_actual_velocities() failed: %s", AmorBus::lastError());
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
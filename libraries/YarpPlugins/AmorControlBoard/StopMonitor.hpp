@@ -0,0 +1,77 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_STOP_MONITOR_HPP__
+#define __AMOR_STOP_MONITOR_HPP__
+
+#include <mutex>
+
+#include <yarp/os/PeriodicThread.h>
+
+#include <amor.h>
+
+#include "AmorBus.hpp"
+#include "StatePoller.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Measures how long each joint takes to come to rest after a stop request.
+ *
+ * Joint velocities are sampled only while stops are pending, from the state
+ * poller's cache if available or through the bus otherwise. A joint is at
+ * rest once its speed drops below the given tolerance [rad/s]; joints that
+ * do not settle within a timeout are counted apart.
+ */
+class StopMonitor : public yarp::os::PeriodicThread
+{
+public:
+    //! Per-joint stopping latencies [s].
+    struct Stats
+    {
+        unsigned int count;
+        unsigned int timeouts;
+        double last;
+        double mean;
+        double max;
+    };
+
+    StopMonitor(AmorBus & bus, const AmorBus::source & origin, const StatePoller * poller,
+                double velocityTolerance, double period)
+        : yarp::os::PeriodicThread(period),
+          bus(bus),
+          origin(origin),
+          poller(poller),
+          velocityTolerance(velocityTolerance)
+    {}
+
+    //! Start timing the given joints, call right before the stop is commanded.
+    void request(int n_joint, const int * joints);
+
+    Stats getStats(int j) const;
+
+    void resetStats();
+
+protected:
+    void run() override;
+
+private:
+    static constexpr double TIMEOUT = 5.0; // [s]
+
+    bool getVelocities(AMOR_VECTOR7 & velocities);
+
+    AmorBus & bus;
+    const AmorBus::source origin;
+    const StatePoller * poller;
+    const double velocityTolerance;
+
+    mutable std::mutex mutex;
+    double requested[AMOR_NUM_JOINTS] {}; //!< zero if not pending
+    double total[AMOR_NUM_JOINTS] {};
+    Stats stats[AMOR_NUM_JOINTS] {};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_STOP_MONITOR_HPP__
@@ -0,0 +1,302 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "TrajectoryGenerator.hpp"
+
+#include <cmath>
+
+#include <algorithm>
+
+#include <yarp/os/Log.h>
+#include <yarp/os/Time.h>
+
+#include "LogComponent.hpp"
+
+using namespace roboticslab;
+
+// -----------------------------------------------------------------------------
+
+double TrajectoryGenerator::Profile::sample(double t, double duration) const
+{
+    if (t <= 0.0)
+    {
+        return start;
+    }
+
+    if (t >= duration)
+    {
+        return start + distance;
+    }
+
+    double s; // travelled distance, non-negative
+
+    if (t < rampTime)
+    {
+        s = 0.5 * acceleration * t * t;
+    }
+    else if (t < duration - rampTime)
+    {
+        s = 0.5 * acceleration * rampTime * rampTime + velocity * (t - rampTime);
+    }
+    else
+    {
+        s = std::abs(distance) - 0.5 * acceleration * (duration - t) * (duration - t);
+    }
+
+    return start + std::copysign(s, distance);
+}
+
+// -----------------------------------------------------------------------------
+
+void TrajectoryGenerator::setRefSpeed(int j, double speed)
+{
+    std::lock_guard lock(mutex);
+    refSpeeds[j] = speed;
+}
+
+// -----------------------------------------------------------------------------
+
+void TrajectoryGenerator::setRefAcceleration(int j, double acceleration)
+{
+    std::lock_guard lock(mutex);
+    refAccelerations[j] = acceleration;
+}
+
+// -----------------------------------------------------------------------------
+
+double TrajectoryGenerator::getRefSpeed(int j) const
+{
+    std::lock_guard lock(mutex);
+    return refSpeeds[j];
+}
+
+// -----------------------------------------------------------------------------
+
+double TrajectoryGenerator::getRefAcceleration(int j) const
+{
+    std::lock_guard lock(mutex);
+    return refAccelerations[j];
+}
+
+// -----------------------------------------------------------------------------
+
+void TrajectoryGenerator::abort()
+{
+    std::lock_guard lock(mutex);
+    active = false;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TrajectoryGenerator::hold(int n_joint, const int * joints)
+{
+    std::lock_guard lock(mutex);
+
+    if (!active)
+    {
+        return false;
+    }
+
+    const double t = yarp::os::Time::now() - startTime;
+
+    for (int i = 0; i < n_joint; i++)
+    {
+        const int j = joints[i];
+        auto & profile = profiles[j];
+
+        profile.start = targets[j] = profile.sample(t, duration);
+        profile.distance = 0.0;
+        profile.velocity = 0.0;
+        profile.rampTime = 0.0;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TrajectoryGenerator::isMoving() const
+{
+    std::lock_guard lock(mutex);
+    return active;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TrajectoryGenerator::getPending(bool * pending) const
+{
+    std::lock_guard lock(mutex);
+
+    if (!active)
+    {
+        std::fill(pending, pending + AMOR_NUM_JOINTS, false);
+        return false;
+    }
+
+    // profiles are synchronized, all moving joints arrive at the end of the move
+    const double t = yarp::os::Time::now() - startTime;
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        pending[j] = profiles[j].distance != 0.0 && t < duration;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TrajectoryGenerator::getTargets(AMOR_VECTOR7 & targets) const
+{
+    std::lock_guard lock(mutex);
+
+    if (!active)
+    {
+        return false;
+    }
+
+    std::copy(this->targets, this->targets + AMOR_NUM_JOINTS, targets);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool TrajectoryGenerator::readStart(AMOR_VECTOR7 & start)
+{
+    if (bus.read(origin, "TrajectoryGenerator", AmorBus::read_kind::ACTUAL_POSITIONS, start) != AMOR_SUCCESS)
+    {
+        yCError(ACB, "amor_get_actual_positions() failed: %s", AmorBus::lastError());
+        return false;
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void TrajectoryGenerator::begin(const AMOR_VECTOR7 & start)
+{
+    // an active trajectory is replanned from where it is instead, keeping the targets of
+    // joints not being commanded
+    std::copy(start, start + AMOR_NUM_JOINTS, setpoints);
+    std::copy(start, start + AMOR_NUM_JOINTS, targets);
+}
+
+// -----------------------------------------------------------------------------
+
+double TrajectoryGenerator::synchronize(const AMOR_VECTOR7 & start, const AMOR_VECTOR7 & end, const AMOR_VECTOR7 & speeds,
+                                        const AMOR_VECTOR7 & accelerations, Profile (& profiles)[AMOR_NUM_JOINTS])
+{
+    double duration = 0.0;
+
+    // the slowest joint sets the pace, either with a triangular or a trapezoidal profile
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        const double d = std::abs(end[j] - start[j]);
+        const double v = speeds[j];
+        const double a = accelerations[j];
+        const double t = d * a < v * v ? 2.0 * std::sqrt(d / a) : d / v + v / a;
+
+        duration = std::max(duration, t);
+    }
+
+    // the others cruise at the lowest speed that allows them to arrive on time
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        auto & profile = profiles[j];
+        const double a = accelerations[j];
+
+        profile.start = start[j];
+        profile.distance = end[j] - start[j];
+        profile.acceleration = a;
+
+        const double discriminant = a * a * duration * duration - 4.0 * a * std::abs(profile.distance);
+        profile.velocity = (a * duration - std::sqrt(std::max(discriminant, 0.0))) / 2.0;
+        profile.rampTime = profile.velocity / a;
+    }
+
+    return duration;
+}
+
+// -----------------------------------------------------------------------------
+
+void TrajectoryGenerator::plan()
+{
+    duration = synchronize(setpoints, targets, refSpeeds, refAccelerations, profiles);
+    startTime = yarp::os::Time::now();
+    epoch = commandCounter;
+    session++;
+    active = true;
+}
+
+// -----------------------------------------------------------------------------
+
+void TrajectoryGenerator::run()
+{
+    AMOR_VECTOR7 sampled, finalTargets;
+    unsigned int sentEpoch, sentSession;
+    bool finished;
+
+    {
+        std::lock_guard lock(mutex);
+
+        if (!active)
+        {
+            return;
+        }
+
+        const double t = yarp::os::Time::now() - startTime;
+        finished = t >= duration;
+
+        for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+        {
+            setpoints[j] = profiles[j].sample(t, duration);
+        }
+
+        std::copy(setpoints, setpoints + AMOR_NUM_JOINTS, sampled);
+        std::copy(targets, targets + AMOR_NUM_JOINTS, finalTargets);
+        sentEpoch = epoch;
+        sentSession = session;
+    }
+
+    const unsigned int planEpoch = sentEpoch;
+
+    // clients are not blocked while the bus is busy
+    bool ok = bus.call(origin, "TrajectoryGenerator", [this, finished, &sampled, &finalTargets, &sentEpoch](AMOR_HANDLE handle)
+        {
+            if (commandCounter != sentEpoch)
+            {
+                yCDebug(ACB, "Trajectory superseded by another command");
+                return false;
+            }
+
+            if (!shadow.write(handle, sampled))
+            {
+                return false;
+            }
+
+            sentEpoch = commandCounter;
+
+            if (finished)
+            {
+                tracker.setTargets(finalTargets);
+            }
+
+            return true;
+        });
+
+    std::lock_guard lock(mutex);
+
+    // a move planned meanwhile took the epoch before our own write, which must not supersede it
+    if (ok && epoch == planEpoch)
+    {
+        epoch = sentEpoch;
+    }
+
+    // ignore the outcome if replanned meanwhile
+    if (session == sentSession && (!ok || finished))
+    {
+        active = false;
+    }
+}
+
+// -----------------------------------------------------------------------------
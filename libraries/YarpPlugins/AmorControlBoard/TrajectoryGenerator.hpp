@@ -0,0 +1,172 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_TRAJECTORY_GENERATOR_HPP__
+#define __AMOR_TRAJECTORY_GENERATOR_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include <yarp/os/PeriodicThread.h>
+
+#include <amor.h>
+
+#include "AmorBus.hpp"
+#include "CommandShadow.hpp"
+#include "MotionTracker.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup AmorControlBoard
+ * @brief Streams time-synchronized trapezoidal position profiles.
+ *
+ * Each move is planned from the current setpoints (or the measured positions
+ * if idle) so that every joint respects its reference speed and acceleration,
+ * and all joints start and finish at the same time. Intermediate setpoints
+ * are sent once per cycle through the position command shadow. The
+ * trajectory is abandoned as soon as any other command reaches the arm, as
+ * signaled by the shared command counter. The final targets are handed over
+ * to the motion tracker once reached. Limits are expressed in SI units and
+ * must be positive.
+ */
+class TrajectoryGenerator : public yarp::os::PeriodicThread
+{
+public:
+    TrajectoryGenerator(AmorBus & bus, const AmorBus::source & origin, CommandShadow & shadow, MotionTracker & tracker,
+                        const std::atomic<unsigned int> & commandCounter, double period)
+        : yarp::os::PeriodicThread(period),
+          bus(bus),
+          origin(origin),
+          shadow(shadow),
+          tracker(tracker),
+          commandCounter(commandCounter)
+    {}
+
+    void setRefSpeed(int j, double speed);
+    void setRefAcceleration(int j, double acceleration);
+    double getRefSpeed(int j) const;
+    double getRefAcceleration(int j) const;
+
+    /**
+     * Plan a new trajectory, replacing the current one (if any).
+     * @param fn callable that edits the target vector, which initially holds
+     * the targets of the current trajectory or the start positions if idle,
+     * may veto the move by returning false.
+     * @return true/false on success/failure.
+     */
+    template <typename Fn>
+    bool move(Fn && fn)
+    {
+        std::unique_lock lock(mutex);
+
+        if (!active)
+        {
+            // other clients must not stall while the start positions are retrieved from the bus
+            lock.unlock();
+            AMOR_VECTOR7 start;
+
+            if (!readStart(start))
+            {
+                return false;
+            }
+
+            lock.lock();
+
+            // another move may have started meanwhile, replan from there instead
+            if (!active)
+            {
+                begin(start);
+            }
+        }
+
+        AMOR_VECTOR7 edited;
+        std::copy(targets, targets + AMOR_NUM_JOINTS, edited);
+
+        if (!editSetpoints(fn, edited))
+        {
+            return false;
+        }
+
+        std::copy(edited, edited + AMOR_NUM_JOINTS, targets);
+        plan();
+        return true;
+    }
+
+    //! Abandon the current trajectory, the arm keeps the last setpoints.
+    void abort();
+
+    /**
+     * Freeze the given joints at their current setpoints, the others carry on.
+     * @return true if a trajectory was active, false if idle.
+     */
+    bool hold(int n_joint, const int * joints);
+
+    //! Whether a trajectory is being streamed.
+    bool isMoving() const;
+
+    /**
+     * Tell which joints are still following their profile, i.e. have some
+     * distance left to cover before the end of the move.
+     * @return false if idle, all flags are then cleared.
+     */
+    bool getPending(bool * pending) const;
+
+    //! Retrieve the targets of the current trajectory, false if idle.
+    bool getTargets(AMOR_VECTOR7 & targets) const;
+
+    //! Trapezoidal (or triangular, if short) position profile of a single joint.
+    struct Profile
+    {
+        double start;
+        double distance; //!< signed
+        double velocity; //!< cruise velocity, non-negative
+        double acceleration;
+        double rampTime;
+
+        //! Position at the given time since the start of a move of the given duration.
+        double sample(double t, double duration) const;
+    };
+
+    /**
+     * Plan time-synchronized profiles between two joint vectors.
+     * @param speeds maximum joint speeds, must be positive.
+     * @param accelerations joint accelerations, must be positive.
+     * @return duration of the move [s], dictated by the slowest joint.
+     */
+    static double synchronize(const AMOR_VECTOR7 & start, const AMOR_VECTOR7 & end, const AMOR_VECTOR7 & speeds,
+                              const AMOR_VECTOR7 & accelerations, Profile (& profiles)[AMOR_NUM_JOINTS]);
+
+protected:
+    void run() override;
+
+private:
+    bool readStart(AMOR_VECTOR7 & start);
+    void begin(const AMOR_VECTOR7 & start);
+    void plan();
+
+    AmorBus & bus;
+    const AmorBus::source origin;
+    CommandShadow & shadow;
+    MotionTracker & tracker;
+    const std::atomic<unsigned int> & commandCounter;
+
+    mutable std::mutex mutex;
+
+    AMOR_VECTOR7 refSpeeds {};
+    AMOR_VECTOR7 refAccelerations {};
+    AMOR_VECTOR7 setpoints {}; //!< last streamed setpoints
+    AMOR_VECTOR7 targets {};
+    Profile profiles[AMOR_NUM_JOINTS] {};
+
+    bool active {false};
+    double startTime {0.0};
+    double duration {0.0};
+    unsigned int epoch {0};
+    unsigned int session {0}; //!< bumped on each plan
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_TRAJECTORY_GENERATOR_HPP__
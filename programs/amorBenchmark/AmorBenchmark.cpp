@@ -0,0 +1,374 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "AmorBenchmark.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <ostream>
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Vocab.h>
+
+#include "LogComponent.hpp"
+
+using namespace roboticslab;
+
+namespace
+{
+    constexpr auto DEFAULT_ITERATIONS = 10000;
+    constexpr auto DEFAULT_WARMUP = 100;
+    constexpr auto DEFAULT_READERS = 2;
+    constexpr auto DEFAULT_WRITERS = 1;
+
+    // streaming commands expected to perform no heap allocations in steady state; twist and
+    // movv are only reported, since they call into the kinematics solver on every command
+    // (diffInvKin() and fwdKin(), respectively), which allocates in the stock KdlSolver
+    constexpr const char * STREAMED_METHODS[] = {"pose"};
+
+    // background threads only run on behalf of the measured call in this scenario
+    constexpr auto QUIET_SCENARIO = "idle";
+
+    void writeJson(std::ostream & os, const std::vector<BenchmarkResult> & results)
+    {
+        os << "{\n  \"units\": \"us\",\n  \"results\": [";
+
+        for (std::size_t i = 0; i < results.size(); i++)
+        {
+            const auto & r = results[i];
+
+            os << (i == 0 ? "\n" : ",\n")
+               << "    {\"method\": \"" << r.method << "\", \"scenario\": \"" << r.scenario << "\""
+               << ", \"calls\": " << r.calls << ", \"failures\": " << r.failures
+               << ", \"mean\": " << r.mean << ", \"p50\": " << r.p50 << ", \"p99\": " << r.p99
+               << ", \"p99.9\": " << r.p999 << ", \"max\": " << r.max
+               << ", \"allocations_per_call\": " << r.allocationsPerCall
+               << ", \"process_allocations_per_call\": " << r.processAllocationsPerCall << "}";
+        }
+
+        os << "\n  ]\n}\n";
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorBenchmark::configure(yarp::os::ResourceFinder & rf)
+{
+    yCDebug(AB) << "amorBenchmark config:" << rf.toString();
+
+    iterations = rf.check("iterations", yarp::os::Value(DEFAULT_ITERATIONS), "measured calls per method").asInt32();
+    warmup = rf.check("warmup", yarp::os::Value(DEFAULT_WARMUP), "unmeasured calls per method").asInt32();
+    readers = rf.check("readers", yarp::os::Value(DEFAULT_READERS), "concurrent encoder readers (loaded scenario)").asInt32();
+    writers = rf.check("writers", yarp::os::Value(DEFAULT_WRITERS), "concurrent position writers (loaded scenario)").asInt32();
+    output = rf.check("output", yarp::os::Value(""), "output JSON file (empty: stdout)").asString();
+    allowStreamAllocations = rf.check("allowStreamAllocations", "do not fail if streamed cartesian commands allocate");
+
+    if (iterations <= 0 || warmup < 0 || readers < 0 || writers < 0)
+    {
+        yCError(AB) << "Illegal iteration or thread count";
+        return false;
+    }
+
+    // remaining options are forwarded to the devices (e.g. --pollPeriodMs)
+    yarp::os::Property options;
+    options.fromString(rf.toString());
+    options.unput("kinematics");
+    options.unput("allowStreamAllocations");
+    options.put("device", "AmorControlBoard");
+
+    if (!controlBoardDevice.open(options))
+    {
+        yCError(AB) << "Unable to open AmorControlBoard device";
+        return false;
+    }
+
+    if (!controlBoardDevice.view(iControlLimits) || !controlBoardDevice.view(iControlMode)
+            || !controlBoardDevice.view(iCurrentControl) || !controlBoardDevice.view(iEncodersTimed)
+            || !controlBoardDevice.view(iPositionControl) || !controlBoardDevice.view(iPositionDirect)
+            || !controlBoardDevice.view(iVelocityControl))
+    {
+        yCError(AB) << "Unable to view control board interfaces";
+        return false;
+    }
+
+    int axes;
+
+    if (!iEncodersTimed->getAxes(&axes))
+    {
+        yCError(AB) << "Unable to retrieve number of axes";
+        return false;
+    }
+
+    initialPositions.resize(axes);
+
+    if (!iEncodersTimed->getEncoders(initialPositions.data()))
+    {
+        yCError(AB) << "Unable to retrieve initial positions";
+        return false;
+    }
+
+    if (rf.check("kinematics", "kinematic description file of the arm, enables cartesian benchmarks"))
+    {
+#ifdef HAVE_CARTESIAN_INTERFACES
+        yarp::os::Property cartesianOptions;
+        cartesianOptions.fromString(rf.toString());
+        cartesianOptions.put("device", "AmorCartesianControl");
+
+        // measure the point-to-point path of pose() on the calling thread, not the tracking loop
+        if (!cartesianOptions.check("posePeriodMs"))
+        {
+            cartesianOptions.put("posePeriodMs", 0);
+        }
+
+        if (!cartesianDevice.open(cartesianOptions))
+        {
+            yCError(AB) << "Unable to open AmorCartesianControl device";
+            return false;
+        }
+
+        if (!cartesianDevice.view(iCartesianControl))
+        {
+            yCError(AB) << "Unable to view ICartesianControl interface";
+            return false;
+        }
+#else
+        yCWarning(AB) << "Built without cartesian interfaces, ignoring --kinematics";
+#endif
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorBenchmark::run()
+{
+    scenario = QUIET_SCENARIO;
+    runControlBoard();
+    runCartesian();
+
+    scenario = "loaded";
+    startLoad();
+    runControlBoard();
+    runCartesian();
+    stopLoad();
+
+    return writeResults() && checkStreamAllocations();
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBenchmark::close()
+{
+    stopLoad();
+
+#ifdef HAVE_CARTESIAN_INTERFACES
+    cartesianDevice.close();
+    iCartesianControl = nullptr;
+#endif
+
+    controlBoardDevice.close();
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBenchmark::runControlBoard()
+{
+    const int axes = initialPositions.size();
+    std::vector<double> values(axes);
+    std::vector<double> timestamps(axes);
+    std::vector<double> zeros(axes, 0.0);
+    std::vector<int> joints(axes);
+    std::vector<int> modes(axes);
+
+    for (int j = 0; j < axes; j++)
+    {
+        joints[j] = j;
+    }
+
+    double min, max;
+
+    measure("getEncoders", [&] { return iEncodersTimed->getEncoders(values.data()); });
+    measure("getEncoder", [&] { return iEncodersTimed->getEncoder(0, values.data()); });
+    measure("getEncodersTimed", [&] { return iEncodersTimed->getEncodersTimed(values.data(), timestamps.data()); });
+    measure("getEncoderSpeeds", [&] { return iEncodersTimed->getEncoderSpeeds(values.data()); });
+    measure("getEncoderAccelerations", [&] { return iEncodersTimed->getEncoderAccelerations(values.data()); });
+    measure("getCurrents", [&] { return iCurrentControl->getCurrents(values.data()); });
+    measure("getRefSpeeds", [&] { return iPositionControl->getRefSpeeds(values.data()); });
+    measure("getLimits", [&] { return iControlLimits->getLimits(0, &min, &max); });
+    measure("getControlModes", [&] { return iControlMode->getControlModes(modes.data()); });
+    measure("getTargetPositions", [&] { return iPositionControl->getTargetPositions(values.data()); });
+    measure("getRefVelocities", [&] { return iVelocityControl->getRefVelocities(values.data()); });
+
+    // commands keep the arm still so that the results do not depend on the order of execution
+    measure("positionMove", [&] { return iPositionControl->positionMove(initialPositions.data()); });
+    measure("positionMove(j)", [&] { return iPositionControl->positionMove(0, initialPositions[0]); });
+    measure("positionMove(n)", [&] { return iPositionControl->positionMove(axes, joints.data(), initialPositions.data()); });
+    measure("relativeMove", [&] { return iPositionControl->relativeMove(zeros.data()); });
+    measure("checkMotionDone", [&] { bool done; return iPositionControl->checkMotionDone(&done); });
+
+    // each command family requires its own control mode
+    setControlModes(VOCAB_CM_POSITION_DIRECT);
+    measure("setPositions", [&] { return iPositionDirect->setPositions(initialPositions.data()); });
+    measure("setPosition", [&] { return iPositionDirect->setPosition(0, initialPositions[0]); });
+
+    setControlModes(VOCAB_CM_VELOCITY);
+    measure("velocityMove", [&] { return iVelocityControl->velocityMove(zeros.data()); });
+    measure("velocityMove(j)", [&] { return iVelocityControl->velocityMove(0, 0.0); });
+    measure("velocityMove(n)", [&] { return iVelocityControl->velocityMove(axes, joints.data(), zeros.data()); });
+
+    iPositionControl->stop();
+    setControlModes(VOCAB_CM_POSITION);
+    iPositionControl->positionMove(initialPositions.data());
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBenchmark::setControlModes(int mode)
+{
+    std::vector<int> modes(initialPositions.size(), mode);
+
+    if (!iControlMode->setControlModes(modes.data()))
+    {
+        yCWarning(AB) << "Unable to switch to" << yarp::os::Vocab32::decode(mode) << "mode";
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBenchmark::runCartesian()
+{
+#ifdef HAVE_CARTESIAN_INTERFACES
+    if (!iCartesianControl)
+    {
+        return;
+    }
+
+    std::vector<double> x, q;
+    int state;
+    double timestamp;
+
+    if (!iCartesianControl->stat(x, &state, &timestamp))
+    {
+        yCWarning(AB) << "Initial cartesian state query failed, skipping cartesian benchmarks";
+        return;
+    }
+
+    const std::vector<double> xd = x;
+    const std::vector<double> xdot(xd.size(), 0.0);
+
+    measure("stat", [&] { return iCartesianControl->stat(x, &state, &timestamp); });
+    measure("inv", [&] { return iCartesianControl->inv(xd, q); });
+    measure("twist", [&] { iCartesianControl->twist(xdot); return true; });
+    measure("movv", [&] { return iCartesianControl->movv(xdot); });
+    measure("pose", [&] { iCartesianControl->pose(xd); return true; });
+
+    iCartesianControl->stopControl();
+#endif
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBenchmark::startLoad()
+{
+    loadRunning = true;
+
+    for (int i = 0; i < readers; i++)
+    {
+        loadThreads.emplace_back([this]
+            {
+                std::vector<double> values(initialPositions.size());
+
+                while (loadRunning)
+                {
+                    iEncodersTimed->getEncoders(values.data());
+                    iCurrentControl->getCurrents(values.data());
+                }
+            });
+    }
+
+    for (int i = 0; i < writers; i++)
+    {
+        loadThreads.emplace_back([this]
+            {
+                while (loadRunning)
+                {
+                    iPositionControl->positionMove(initialPositions.data());
+                }
+            });
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void AmorBenchmark::stopLoad()
+{
+    loadRunning = false;
+
+    for (auto & thread : loadThreads)
+    {
+        thread.join();
+    }
+
+    loadThreads.clear();
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorBenchmark::checkStreamAllocations() const
+{
+    bool ok = true;
+
+    for (const auto & r : results)
+    {
+        for (const auto * method : STREAMED_METHODS)
+        {
+            if (r.method != method)
+            {
+                continue;
+            }
+
+            if (r.allocationsPerCall > 0.0)
+            {
+                yCError(AB, "Streamed command %s performed %f heap allocations per call on the calling thread (%s scenario)",
+                        method, r.allocationsPerCall, r.scenario.c_str());
+                ok = false;
+            }
+
+            // other threads (bus I/O, pollers) may be accounted to the call only if nothing else is running
+            if (r.scenario == QUIET_SCENARIO && r.processAllocationsPerCall > r.allocationsPerCall)
+            {
+                yCError(AB, "Streamed command %s performed %f heap allocations per call on other threads (%s scenario)",
+                        method, r.processAllocationsPerCall - r.allocationsPerCall, r.scenario.c_str());
+                ok = false;
+            }
+        }
+    }
+
+    return ok || allowStreamAllocations;
+}
+
+// -----------------------------------------------------------------------------
+
+bool AmorBenchmark::writeResults() const
+{
+    if (output.empty())
+    {
+        writeJson(std::cout, results);
+        return true;
+    }
+
+    std::ofstream ofs(output);
+
+    if (!ofs)
+    {
+        yCError(AB) << "Unable to open output file" << output;
+        return false;
+    }
+
+    writeJson(ofs, results);
+    yCInfo(AB) << "Results written to" << output;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
@@ -0,0 +1,107 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_BENCHMARK_HPP__
+#define __AMOR_BENCHMARK_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <yarp/dev/PolyDriver.h>
+
+#ifdef HAVE_CARTESIAN_INTERFACES
+# include "ICartesianControl.h"
+#endif
+
+#include "LatencyRecorder.hpp"
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup amorBenchmark
+ * @brief Measures the cost of interface calls on the AMOR devices.
+ */
+class AmorBenchmark
+{
+public:
+    ~AmorBenchmark()
+    { close(); }
+
+    bool configure(yarp::os::ResourceFinder & rf);
+    bool run();
+    void close();
+
+private:
+    template <typename Fn>
+    void measure(const std::string & method, Fn && fn)
+    {
+        for (int i = 0; i < warmup; i++)
+        {
+            fn();
+        }
+
+        LatencyRecorder recorder(iterations);
+
+        for (int i = 0; i < iterations; i++)
+        {
+            auto allocs = LatencyRecorder::threadAllocations();
+            auto processAllocs = LatencyRecorder::processAllocations();
+            auto start = std::chrono::steady_clock::now();
+            bool ok = fn();
+            auto end = std::chrono::steady_clock::now();
+            allocs = LatencyRecorder::threadAllocations() - allocs;
+            processAllocs = LatencyRecorder::processAllocations() - processAllocs;
+
+            recorder.record(std::chrono::duration<double>(end - start).count(), allocs, processAllocs, ok);
+        }
+
+        results.push_back(recorder.summarize(method, scenario));
+    }
+
+    void runControlBoard();
+    void setControlModes(int mode);
+    void runCartesian();
+    void startLoad();
+    void stopLoad();
+    bool writeResults() const;
+
+    //! Whether streamed cartesian commands stayed allocation-free, see --allowStreamAllocations.
+    bool checkStreamAllocations() const;
+
+    yarp::dev::PolyDriver controlBoardDevice;
+    yarp::dev::IControlLimits * iControlLimits {nullptr};
+    yarp::dev::IControlMode * iControlMode {nullptr};
+    yarp::dev::ICurrentControl * iCurrentControl {nullptr};
+    yarp::dev::IEncodersTimed * iEncodersTimed {nullptr};
+    yarp::dev::IPositionControl * iPositionControl {nullptr};
+    yarp::dev::IPositionDirect * iPositionDirect {nullptr};
+    yarp::dev::IVelocityControl * iVelocityControl {nullptr};
+
+#ifdef HAVE_CARTESIAN_INTERFACES
+    yarp::dev::PolyDriver cartesianDevice;
+    ICartesianControl * iCartesianControl {nullptr};
+#endif
+
+    int iterations;
+    int warmup;
+    int readers;
+    int writers;
+    std::string output;
+    bool allowStreamAllocations;
+    std::string scenario;
+
+    std::vector<double> initialPositions;
+    std::vector<BenchmarkResult> results;
+
+    std::atomic<bool> loadRunning {false};
+    std::vector<std::thread> loadThreads;
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_BENCHMARK_HPP__
@@ -0,0 +1,109 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#include "LatencyRecorder.hpp"
+
+#include <cstdlib>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <numeric>
+
+using namespace roboticslab;
+
+namespace
+{
+    thread_local std::size_t allocationCount = 0;
+    std::atomic<std::size_t> processAllocationCount {0};
+
+    double percentile(const std::vector<double> & sorted, double p)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+
+        auto idx = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(idx, sorted.size() - 1)];
+    }
+}
+
+// Replace global allocation functions so that every heap allocation, including
+// those inside dynamically loaded plugins, is accounted for both per thread and
+// process-wide (e.g. on the bus I/O thread or in control loops). Array and
+// nothrow variants forward to these by default.
+
+void * operator new(std::size_t size)
+{
+    allocationCount++;
+    processAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void * ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// -----------------------------------------------------------------------------
+
+std::size_t LatencyRecorder::threadAllocations()
+{
+    return allocationCount;
+}
+
+// -----------------------------------------------------------------------------
+
+std::size_t LatencyRecorder::processAllocations()
+{
+    return processAllocationCount.load(std::memory_order_relaxed);
+}
+
+// -----------------------------------------------------------------------------
+
+void LatencyRecorder::record(double seconds, std::size_t allocs, std::size_t processAllocs, bool ok)
+{
+    samples.push_back(seconds * 1e6);
+    allocations += allocs;
+    totalAllocations += processAllocs;
+
+    if (!ok)
+    {
+        failures++;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+BenchmarkResult LatencyRecorder::summarize(const std::string & method, const std::string & scenario) const
+{
+    auto sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    BenchmarkResult result;
+    result.method = method;
+    result.scenario = scenario;
+    result.calls = sorted.size();
+    result.failures = failures;
+    result.mean = sorted.empty() ? 0.0 : std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+    result.p50 = percentile(sorted, 0.5);
+    result.p99 = percentile(sorted, 0.99);
+    result.p999 = percentile(sorted, 0.999);
+    result.max = sorted.empty() ? 0.0 : sorted.back();
+    result.allocationsPerCall = sorted.empty() ? 0.0 : static_cast<double>(allocations) / sorted.size();
+    result.processAllocationsPerCall = sorted.empty() ? 0.0 : static_cast<double>(totalAllocations) / sorted.size();
+    return result;
+}
+
+// -----------------------------------------------------------------------------
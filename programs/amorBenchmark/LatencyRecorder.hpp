@@ -0,0 +1,63 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+#ifndef __AMOR_LATENCY_RECORDER_HPP__
+#define __AMOR_LATENCY_RECORDER_HPP__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace roboticslab
+{
+
+/**
+ * @ingroup amorBenchmark
+ * @brief Summary of the latencies recorded for a single interface method.
+ */
+struct BenchmarkResult
+{
+    std::string method;
+    std::string scenario;
+    std::size_t calls;
+    std::size_t failures;
+    double mean; //!< [us]
+    double p50; //!< [us]
+    double p99; //!< [us]
+    double p999; //!< [us]
+    double max; //!< [us]
+    double allocationsPerCall; //!< on the calling thread
+    double processAllocationsPerCall; //!< on any thread while the call was in progress
+};
+
+/**
+ * @ingroup amorBenchmark
+ * @brief Collects per-call latencies and heap allocation counts.
+ */
+class LatencyRecorder
+{
+public:
+    explicit LatencyRecorder(std::size_t capacity)
+    { samples.reserve(capacity); }
+
+    //! Store the outcome of a single call.
+    void record(double seconds, std::size_t allocations, std::size_t processAllocations, bool ok);
+
+    //! Compute latency percentiles and mean allocations per call.
+    BenchmarkResult summarize(const std::string & method, const std::string & scenario) const;
+
+    //! Number of heap allocations performed so far by the calling thread.
+    static std::size_t threadAllocations();
+
+    //! Number of heap allocations performed so far by all threads.
+    static std::size_t processAllocations();
+
+private:
+    std::vector<double> samples;
+    std::size_t allocations {0};
+    std::size_t totalAllocations {0}; // any thread
+    std::size_t failures {0};
+};
+
+} // namespace roboticslab
+
+#endif // __AMOR_LATENCY_RECORDER_HPP__
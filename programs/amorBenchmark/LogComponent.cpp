@@ -0,0 +1,3 @@
+#include "LogComponent.hpp"
+
+YARP_LOG_COMPONENT(AB, "rl.amorBenchmark")
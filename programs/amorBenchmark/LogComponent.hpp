@@ -0,0 +1,8 @@
+#ifndef __AMOR_BENCHMARK_LOG_COMPONENT_HPP__
+#define __AMOR_BENCHMARK_LOG_COMPONENT_HPP__
+
+#include <yarp/os/LogComponent.h>
+
+YARP_DECLARE_LOG_COMPONENT(AB)
+
+#endif // __AMOR_BENCHMARK_LOG_COMPONENT_HPP__
@@ -0,0 +1,82 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/**
+ * @ingroup amor_yarp_devices_programs
+ * @defgroup amorBenchmark amorBenchmark
+ * @brief Measures latency and heap allocations of the AMOR device interfaces.
+ *
+ * Opens an AmorControlBoard device (and, if `--kinematics` is given, an
+ * AmorCartesianControl device) in-process, then times every supported
+ * interface method on its own and while other threads keep reading encoders
+ * and sending position commands. For each method, mean, p50, p99, p99.9 and
+ * max latencies in microseconds are reported together with the average
+ * number of heap allocations per call, in JSON format, both on the calling
+ * thread and process-wide while the call was in progress. The program fails
+ * if the streamed pose command allocates in steady state on the calling
+ * thread or, in the idle scenario, on any other thread such as the bus I/O
+ * thread. Periodic reports (e.g. `--busStatsPeriod`) allocate as well and
+ * should be left disabled.
+ *
+ * Allocations within the kinematics solver are counted too. The stock
+ * KdlSolver allocates in its forward, differential and inverse kinematics
+ * routines. The twist and movv streaming commands call the solver on every
+ * command (diffInvKin() and fwdKin(), respectively), hence their allocations
+ * are reported but never fail the run. Pose skips the solver on an exact IK
+ * cache hit as long as the cache is enabled (`--ikCacheSize`), since its
+ * target does not change; use `--allowStreamAllocations` if disabled. The
+ * device code on these paths is not covered by any test, only the building
+ * blocks it relies on (bus, setpoint filter, watchdog, IK seed cache and
+ * motion monitor) are checked not to allocate by the unit tests.
+ *
+ * The cartesian device is opened with `--posePeriodMs 0` unless given, so that
+ * pose is measured through the point-to-point path on the calling thread
+ * instead of merely updating the reference of the tracking loop.
+ *
+ * Meant to be run against the simulated AMOR API (see AmorSimLib), whose bus
+ * latency may be tuned through the `AMOR_SIM_LATENCY_US` and
+ * `AMOR_SIM_JITTER_US` environment variables. Plugins are looked up as usual,
+ * i.e. `YARP_DATA_DIRS` must point to the build or install share directory.
+ *
+ * Options (any other option is forwarded to the devices):
+ *
+ * - `--iterations` measured calls per method (default: 10000)
+ * - `--warmup` unmeasured calls per method (default: 100)
+ * - `--readers` concurrent encoder readers in the loaded scenario (default: 2)
+ * - `--writers` concurrent position writers in the loaded scenario (default: 1)
+ * - `--output` output JSON file (default: standard output)
+ * - `--kinematics` kinematic description file, enables cartesian methods
+ * - `--allowStreamAllocations` do not fail if the streamed pose command
+ *   performs heap allocations
+ *
+ * Example:
+ *
+ * @code{.sh}
+ * AMOR_SIM_LATENCY_US=200 amorBenchmark --pollPeriodMs 5 --output results.json
+ * @endcode
+ */
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/ResourceFinder.h>
+
+#include "AmorBenchmark.hpp"
+#include "LogComponent.hpp"
+
+int main(int argc, char * argv[])
+{
+    yarp::os::Network yarp;
+
+    yarp::os::ResourceFinder rf;
+    rf.setDefaultContext("amorBenchmark");
+    rf.configure(argc, argv);
+
+    roboticslab::AmorBenchmark benchmark;
+
+    if (!benchmark.configure(rf))
+    {
+        yCError(AB) << "Benchmark configuration failed";
+        return 1;
+    }
+
+    return benchmark.run() ? 0 : 1;
+}
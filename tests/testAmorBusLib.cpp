@@ -0,0 +1,282 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <amor.h>
+#include <amor_sim.h>
+
+#include "AmorBus.hpp"
+#include "DeadmanWatchdog.hpp"
+#include "MpscQueue.hpp"
+#include "SetpointFilter.hpp"
+
+namespace roboticslab::test
+{
+
+namespace
+{
+    struct Node : MpscNode
+    {
+        int producer;
+        int sequence;
+    };
+
+    double zeroTime()
+    {
+        return 0.0;
+    }
+}
+
+/**
+ * @ingroup amor_yarp_devices_tests
+ * @brief Tests the building blocks of @ref AmorBusLib, talking to the simulated arm.
+ */
+class AmorBusLibTest : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        char name[] = "libamor_api";
+        handle = amor_connect(name, 0);
+        ASSERT_NE(handle, AMOR_INVALID_HANDLE);
+    }
+
+    void TearDown() override
+    {
+        amor_release(handle);
+    }
+
+protected:
+    AMOR_HANDLE handle {AMOR_INVALID_HANDLE};
+    const AmorBus::source normal {"test"};
+};
+
+TEST_F(AmorBusLibTest, MpscQueueFifo)
+{
+    MpscQueue queue;
+    Node nodes[3];
+
+    ASSERT_EQ(queue.pop(), nullptr);
+
+    for (int i = 0; i < 3; i++)
+    {
+        nodes[i].sequence = i;
+        queue.push(&nodes[i]);
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        auto * node = static_cast<Node *>(queue.pop());
+        ASSERT_NE(node, nullptr);
+        ASSERT_EQ(node->sequence, i);
+    }
+
+    ASSERT_EQ(queue.pop(), nullptr);
+
+    // nodes may be pushed again once popped
+    queue.push(&nodes[1]);
+    ASSERT_EQ(queue.pop(), &nodes[1]);
+    ASSERT_EQ(queue.pop(), nullptr);
+}
+
+TEST_F(AmorBusLibTest, MpscQueueConcurrentProducers)
+{
+    constexpr int PRODUCERS = 4;
+    constexpr int NODES = 10000;
+
+    MpscQueue queue;
+    std::vector<Node> nodes(PRODUCERS * NODES);
+    std::vector<std::thread> producers;
+
+    for (int p = 0; p < PRODUCERS; p++)
+    {
+        producers.emplace_back([&queue, &nodes, p]
+            {
+                for (int i = 0; i < NODES; i++)
+                {
+                    auto & node = nodes[p * NODES + i];
+                    node.producer = p;
+                    node.sequence = i;
+                    queue.push(&node);
+                }
+            });
+    }
+
+    // per-producer order must be preserved
+    int next[PRODUCERS] {};
+    int popped = 0;
+
+    while (popped < PRODUCERS * NODES)
+    {
+        if (auto * node = static_cast<Node *>(queue.pop()))
+        {
+            ASSERT_EQ(node->sequence, next[node->producer]++);
+            popped++;
+        }
+    }
+
+    for (auto & producer : producers)
+    {
+        producer.join();
+    }
+
+    ASSERT_EQ(queue.pop(), nullptr);
+}
+
+TEST_F(AmorBusLibTest, SetpointFilter)
+{
+    SetpointFilter filter;
+    AMOR_VECTOR7 frame {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7};
+
+    // disabled by default
+    filter.sent(frame, 1, 0.0);
+    ASSERT_FALSE(filter.suppress(frame, 1, 0.01));
+
+    filter.configure(1e-3, 0.1);
+    ASSERT_FALSE(filter.suppress(frame, 1, 0.0)); // configure() forgets the last frame
+    filter.sent(frame, 1, 0.0);
+
+    AMOR_VECTOR7 near {0.1005, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7};
+    AMOR_VECTOR7 far {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.702};
+
+    ASSERT_TRUE(filter.suppress(frame, 1, 0.01));
+    ASSERT_TRUE(filter.suppress(near, 1, 0.02));
+    ASSERT_FALSE(filter.suppress(far, 1, 0.03)); // outside the deadband
+    ASSERT_FALSE(filter.suppress(frame, 2, 0.04)); // another command in between
+    ASSERT_FALSE(filter.suppress(frame, 1, 0.1)); // keep-alive
+
+    filter.reset();
+    ASSERT_FALSE(filter.suppress(frame, 1, 0.01));
+
+    ASSERT_EQ(filter.getSent(), 2);
+    ASSERT_EQ(filter.getSuppressed(), 2);
+
+    filter.resetCounters();
+    ASSERT_EQ(filter.getSent(), 0);
+    ASSERT_EQ(filter.getSuppressed(), 0);
+}
+
+TEST_F(AmorBusLibTest, DeadmanWatchdog)
+{
+    std::atomic<int> expired {0};
+    DeadmanWatchdog watchdog([&expired] { expired++; });
+
+    ASSERT_TRUE(watchdog.start());
+    ASSERT_FALSE(watchdog.start());
+
+    // kept alive
+    for (int i = 0; i < 10; i++)
+    {
+        watchdog.kick(0.1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(expired, 0);
+
+    // a shorter timeout takes effect at once
+    watchdog.kick(10.0);
+    watchdog.kick(0.02);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(expired, 1);
+    ASSERT_EQ(watchdog.getTrips(), 1);
+
+    // disarmed
+    watchdog.kick(0.02);
+    watchdog.disarm();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    ASSERT_EQ(expired, 1);
+
+    watchdog.kick(10.0);
+    watchdog.stop();
+    ASSERT_EQ(expired, 1);
+}
+
+TEST_F(AmorBusLibTest, AmorBusCall)
+{
+    AmorBus bus(handle, zeroTime);
+    ASSERT_TRUE(bus.start());
+
+    AMOR_VECTOR7 targets {0.1, -0.1, 0.0, 0.0, 0.0, 0.0, 0.0};
+    ASSERT_EQ(bus.call(normal, "set", [&targets](AMOR_HANDLE h) { return amor_set_positions(h, targets); }), AMOR_SUCCESS);
+
+    AMOR_VECTOR7 requested;
+    ASSERT_EQ(bus.call(normal, "get", [&requested](AMOR_HANDLE h) { return amor_get_req_positions(h, &requested); }), AMOR_SUCCESS);
+    ASSERT_DOUBLE_EQ(requested[0], targets[0]);
+    ASSERT_DOUBLE_EQ(requested[1], targets[1]);
+
+    // any non-void result is passed through
+    ASSERT_EQ(bus.call(normal, "value", [](AMOR_HANDLE) { return 42; }), 42);
+
+    // reads issued one after another are never coalesced
+    unsigned long before, after;
+    ASSERT_EQ(amor_sim_get_call_count(handle, &before), AMOR_SUCCESS);
+
+    AMOR_VECTOR7 positions;
+
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_EQ(bus.read(normal, "read", AmorBus::read_kind::ACTUAL_POSITIONS, positions), AMOR_SUCCESS);
+    }
+
+    ASSERT_EQ(amor_sim_get_call_count(handle, &after), AMOR_SUCCESS);
+    ASSERT_EQ(after - before, 100);
+
+    // failures are reported along with the message of the API
+    ASSERT_EQ(amor_sim_fail_next(handle, 1), AMOR_SUCCESS);
+    ASSERT_EQ(bus.read(normal, "read", AmorBus::read_kind::ACTUAL_POSITIONS, positions), AMOR_FAILED);
+    ASSERT_GT(std::strlen(AmorBus::lastError()), 0);
+    ASSERT_EQ(bus.read(normal, "read", AmorBus::read_kind::ACTUAL_POSITIONS, positions), AMOR_SUCCESS);
+
+    bus.stop();
+}
+
+TEST_F(AmorBusLibTest, AmorBusStop)
+{
+    AmorBus bus(handle, zeroTime);
+
+    // serviced by the caller while stopped
+    AMOR_VECTOR7 positions;
+    ASSERT_EQ(bus.read(normal, "read", AmorBus::read_kind::ACTUAL_POSITIONS, positions), AMOR_SUCCESS);
+
+    ASSERT_TRUE(bus.start());
+
+    std::atomic<bool> done {false};
+    std::atomic<int> failed {0};
+    std::vector<std::thread> clients;
+
+    for (int i = 0; i < 4; i++)
+    {
+        clients.emplace_back([&bus, &done, &failed, this]
+            {
+                AMOR_VECTOR7 values;
+
+                while (!done)
+                {
+                    if (bus.read(normal, "read", AmorBus::read_kind::ACTUAL_VELOCITIES, values) != AMOR_SUCCESS)
+                    {
+                        failed++;
+                    }
+                }
+            });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // no request is lost or left hanging across a stop
+    bus.stop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    done = true;
+
+    for (auto & client : clients)
+    {
+        client.join();
+    }
+
+    ASSERT_EQ(failed, 0);
+}
+
+} // namespace roboticslab::test
@@ -0,0 +1,188 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "IkSeedCache.hpp"
+#include "MotionStatusMonitor.hpp"
+
+namespace roboticslab::test
+{
+
+/**
+ * @ingroup amor_yarp_devices_tests
+ * @brief Tests the helper classes of @ref AmorCartesianControl.
+ */
+class AmorCartesianControlTest : public testing::Test
+{
+public:
+    void SetUp() override
+    {}
+
+    void TearDown() override
+    {}
+
+protected:
+    using outcome = MotionStatusMonitor::outcome;
+};
+
+TEST_F(AmorCartesianControlTest, IkSeedCacheDisabled)
+{
+    IkSeedCache cache;
+    ASSERT_FALSE(cache.isEnabled());
+
+    std::vector<double> x {0.1, 0.2, 0.3}, q {1.0, 2.0};
+    cache.store(x, q);
+    ASSERT_EQ(cache.find(x, q), IkSeedCache::match::NONE);
+}
+
+TEST_F(AmorCartesianControlTest, IkSeedCacheLookup)
+{
+    IkSeedCache cache;
+    cache.configure(2, 0.01);
+    ASSERT_TRUE(cache.isEnabled());
+
+    const std::vector<double> x1 {0.1, 0.2, 0.3}, q1 {1.0, 2.0};
+    const std::vector<double> x2 {0.4, 0.5, 0.6}, q2 {3.0, 4.0};
+    const std::vector<double> x3 {0.7, 0.8, 0.9}, q3 {5.0, 6.0};
+
+    std::vector<double> q;
+    ASSERT_EQ(cache.find(x1, q), IkSeedCache::match::NONE);
+
+    cache.store(x1, q1);
+    cache.store(x2, q2);
+
+    ASSERT_EQ(cache.find(x1, q), IkSeedCache::match::EXACT);
+    ASSERT_EQ(q, q1);
+
+    ASSERT_EQ(cache.find({0.405, 0.5, 0.6}, q), IkSeedCache::match::NEAR);
+    ASSERT_EQ(q, q2);
+
+    ASSERT_EQ(cache.find({0.42, 0.5, 0.6}, q), IkSeedCache::match::NONE); // outside the radius
+    ASSERT_EQ(cache.find({0.1, 0.2}, q), IkSeedCache::match::NONE); // size mismatch
+
+    // x1 is now the least recently used entry
+    cache.store(x3, q3);
+    ASSERT_EQ(cache.find(x1, q), IkSeedCache::match::NONE);
+    ASSERT_EQ(cache.find(x2, q), IkSeedCache::match::EXACT);
+    ASSERT_EQ(cache.find(x3, q), IkSeedCache::match::EXACT);
+    ASSERT_EQ(q, q3);
+
+    // reconfiguring drops all entries
+    cache.configure(2, 0.01);
+    ASSERT_EQ(cache.find(x3, q), IkSeedCache::match::NONE);
+}
+
+TEST_F(AmorCartesianControlTest, IkSeedCacheStats)
+{
+    IkSeedCache cache;
+
+    cache.account(IkSeedCache::match::EXACT, 0, true, 0.001);
+    cache.account(IkSeedCache::match::NEAR, 1, true, 0.002);
+    cache.account(IkSeedCache::match::NEAR, 2, true, 0.004); // retried from the measured joint state
+    cache.account(IkSeedCache::match::NONE, 2, false, 0.005);
+
+    const auto stats = cache.getStats();
+
+    ASSERT_EQ(stats.calls, 4);
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(stats.warmStarts, 1);
+    ASSERT_EQ(stats.attempts, 5);
+    ASSERT_EQ(stats.failures, 1);
+    ASSERT_DOUBLE_EQ(stats.lastTime, 0.005);
+    ASSERT_NEAR(stats.meanTime, 0.003, 1e-12);
+    ASSERT_DOUBLE_EQ(stats.maxTime, 0.005);
+}
+
+TEST_F(AmorCartesianControlTest, MotionStatusMonitorFinished)
+{
+    using clock = std::chrono::steady_clock;
+
+    std::atomic<clock::time_point> end {clock::time_point::max()};
+    std::atomic<int> polls {0};
+
+    MotionStatusMonitor monitor([&end, &polls](bool & finished)
+        {
+            polls++;
+            finished = clock::now() >= end.load();
+            return true;
+        });
+
+    monitor.setPeriods(0.02, 0.002);
+    ASSERT_TRUE(monitor.start());
+
+    // idle, nothing to wait for
+    ASSERT_EQ(monitor.wait(1.0), outcome::FINISHED);
+    ASSERT_EQ(polls, 0);
+
+    end = clock::now() + std::chrono::milliseconds(100);
+    monitor.expect(0.1);
+
+    // any number of waiters is served by the same polls
+    std::vector<std::thread> waiters;
+    std::atomic<int> finished {0};
+
+    for (int i = 0; i < 4; i++)
+    {
+        waiters.emplace_back([&monitor, &finished]
+            {
+                if (monitor.wait(5.0) == outcome::FINISHED)
+                {
+                    finished++;
+                }
+            });
+    }
+
+    for (auto & waiter : waiters)
+    {
+        waiter.join();
+    }
+
+    ASSERT_EQ(finished, 4);
+    ASSERT_GE(clock::now(), end.load());
+    ASSERT_LT(polls, 60); // far fewer than one per fine period, let alone per waiter
+
+    // not polled while nobody waits
+    const int before = polls;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(polls, before);
+
+    monitor.stop();
+}
+
+TEST_F(AmorCartesianControlTest, MotionStatusMonitorTimeout)
+{
+    MotionStatusMonitor monitor([](bool & finished) { finished = false; return true; });
+
+    monitor.setPeriods(0.01, 0.002);
+    ASSERT_TRUE(monitor.start());
+
+    monitor.expect(0.0);
+    ASSERT_EQ(monitor.wait(0.05), outcome::TIMEOUT);
+
+    // waiters are released on stop
+    std::thread waiter([&monitor] { ASSERT_EQ(monitor.wait(0.0), outcome::FAILED); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    monitor.stop();
+    waiter.join();
+}
+
+TEST_F(AmorCartesianControlTest, MotionStatusMonitorFailed)
+{
+    std::atomic<bool> ok {true};
+
+    MotionStatusMonitor monitor([&ok](bool & finished) { finished = false; return ok.load(); });
+
+    monitor.setPeriods(0.01, 0.002);
+    ASSERT_TRUE(monitor.start());
+
+    monitor.expect(0.05);
+    ok = false;
+    ASSERT_EQ(monitor.wait(1.0), outcome::FAILED);
+
+    monitor.stop();
+}
+
+} // namespace roboticslab::test
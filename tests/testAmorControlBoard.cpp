@@ -0,0 +1,428 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include <amor.h>
+
+#include "AmorControlBoard.hpp"
+#include "CommandShadow.hpp"
+#include "EncoderHistory.hpp"
+#include "MotionTracker.hpp"
+#include "SoftLimits.hpp"
+#include "TrajectoryGenerator.hpp"
+
+namespace roboticslab::test
+{
+
+namespace
+{
+    // stand-ins for the setpoint getters and setters of the AMOR API
+    AMOR_VECTOR7 measured, requested, written;
+    int writes = 0;
+    bool failWrites = false;
+
+    AMOR_RESULT getMeasured(AMOR_HANDLE, AMOR_VECTOR7 * values)
+    {
+        std::copy(measured, measured + AMOR_NUM_JOINTS, *values);
+        return AMOR_SUCCESS;
+    }
+
+    AMOR_RESULT getRequested(AMOR_HANDLE, AMOR_VECTOR7 * values)
+    {
+        std::copy(requested, requested + AMOR_NUM_JOINTS, *values);
+        return AMOR_SUCCESS;
+    }
+
+    AMOR_RESULT setWritten(AMOR_HANDLE, AMOR_VECTOR7 values)
+    {
+        if (failWrites)
+        {
+            return AMOR_FAILED;
+        }
+
+        std::copy(values, values + AMOR_NUM_JOINTS, written);
+        writes++;
+        return AMOR_SUCCESS;
+    }
+
+    // exposes the joint index checks shared by all n_joint methods of the device
+    struct JointIndices : AmorControlBoard
+    {
+        using AmorControlBoard::indexWithinRange;
+        using AmorControlBoard::batchWithinRange;
+    };
+}
+
+/**
+ * @ingroup amor_yarp_devices_tests
+ * @brief Tests the helper classes and the joint index checks of @ref AmorControlBoard.
+ */
+class AmorControlBoardTest : public testing::Test
+{
+public:
+    void SetUp() override
+    {}
+
+    void TearDown() override
+    {}
+
+protected:
+    using Profile = TrajectoryGenerator::Profile;
+
+    static constexpr double EPSILON = 1e-9;
+
+    static void fill(AMOR_VECTOR7 & v, double value)
+    {
+        for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+        {
+            v[j] = value;
+        }
+    }
+};
+
+TEST_F(AmorControlBoardTest, TrajectoryTrapezoidal)
+{
+    AMOR_VECTOR7 start, end, speeds, accelerations;
+    fill(start, 0.0);
+    fill(end, 0.0);
+    fill(speeds, 0.5);
+    fill(accelerations, 1.0);
+    end[0] = 1.0;
+
+    Profile profiles[AMOR_NUM_JOINTS];
+    const double duration = TrajectoryGenerator::synchronize(start, end, speeds, accelerations, profiles);
+
+    // 0.5 s ramps at both ends, 1.5 s cruising at 0.5 rad/s
+    ASSERT_NEAR(duration, 2.5, EPSILON);
+    ASSERT_NEAR(profiles[0].velocity, 0.5, EPSILON);
+    ASSERT_NEAR(profiles[0].rampTime, 0.5, EPSILON);
+
+    ASSERT_NEAR(profiles[0].sample(0.0, duration), 0.0, EPSILON);
+    ASSERT_NEAR(profiles[0].sample(0.5, duration), 0.125, EPSILON);
+    ASSERT_NEAR(profiles[0].sample(1.25, duration), 0.5, EPSILON);
+    ASSERT_NEAR(profiles[0].sample(2.0, duration), 0.875, EPSILON);
+    ASSERT_NEAR(profiles[0].sample(duration, duration), 1.0, EPSILON);
+    ASSERT_NEAR(profiles[0].sample(duration + 1.0, duration), 1.0, EPSILON);
+
+    // still joints stay put
+    for (int j = 1; j < AMOR_NUM_JOINTS; j++)
+    {
+        ASSERT_NEAR(profiles[j].sample(1.0, duration), 0.0, EPSILON);
+    }
+}
+
+TEST_F(AmorControlBoardTest, TrajectoryTriangular)
+{
+    AMOR_VECTOR7 start, end, speeds, accelerations;
+    fill(start, 0.2);
+    fill(end, 0.2);
+    fill(speeds, 0.5);
+    fill(accelerations, 1.0);
+    end[3] = 0.1; // too short to reach cruise speed, and backwards
+
+    Profile profiles[AMOR_NUM_JOINTS];
+    const double duration = TrajectoryGenerator::synchronize(start, end, speeds, accelerations, profiles);
+
+    ASSERT_NEAR(duration, 2.0 * std::sqrt(0.1), EPSILON);
+    ASSERT_LE(profiles[3].velocity, speeds[3]);
+    ASSERT_NEAR(profiles[3].sample(duration / 2.0, duration), 0.15, EPSILON);
+    ASSERT_NEAR(profiles[3].sample(duration, duration), 0.1, EPSILON);
+}
+
+TEST_F(AmorControlBoardTest, TrajectorySynchronized)
+{
+    AMOR_VECTOR7 start, end, speeds, accelerations;
+    fill(start, 0.0);
+    fill(speeds, 0.5);
+    fill(accelerations, 1.0);
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        end[j] = (j % 2 ? -0.1 : 0.1) * (j + 1);
+    }
+
+    Profile profiles[AMOR_NUM_JOINTS];
+    const double duration = TrajectoryGenerator::synchronize(start, end, speeds, accelerations, profiles);
+
+    // the farthest joint dictates the duration
+    ASSERT_NEAR(duration, 0.7 / 0.5 + 0.5 / 1.0, EPSILON);
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        ASSERT_LE(profiles[j].velocity, speeds[j] + EPSILON);
+        ASSERT_NEAR(profiles[j].sample(duration, duration), end[j], EPSILON);
+
+        // all joints arrive at the same time, hence none is there earlier
+        if (end[j] != start[j])
+        {
+            ASSERT_GT(std::abs(profiles[j].sample(0.9 * duration, duration) - end[j]), EPSILON);
+        }
+
+        // monotonic
+        double previous = start[j];
+
+        for (int i = 1; i <= 100; i++)
+        {
+            const double q = profiles[j].sample(duration * i / 100.0, duration);
+            ASSERT_GE((q - previous) * std::copysign(1.0, end[j]), -EPSILON);
+            previous = q;
+        }
+    }
+}
+
+TEST_F(AmorControlBoardTest, TrajectoryStill)
+{
+    AMOR_VECTOR7 start, speeds, accelerations;
+    fill(start, 0.3);
+    fill(speeds, 0.5);
+    fill(accelerations, 1.0);
+
+    Profile profiles[AMOR_NUM_JOINTS];
+    const double duration = TrajectoryGenerator::synchronize(start, start, speeds, accelerations, profiles);
+
+    ASSERT_EQ(duration, 0.0);
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        ASSERT_FALSE(std::isnan(profiles[j].velocity));
+        ASSERT_EQ(profiles[j].sample(0.0, duration), 0.3);
+    }
+}
+
+TEST_F(AmorControlBoardTest, EncoderHistory)
+{
+    AMOR_VECTOR7 positions, velocities, accelerations;
+    fill(positions, 0.0);
+
+    EncoderHistory history(4);
+    ASSERT_FALSE(history.estimateAccelerations(accelerations));
+
+    // constant acceleration of j rad/s^2 per joint
+    for (int i = 0; i < 10; i++)
+    {
+        const double t = 100.0 + 0.01 * i;
+
+        for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+        {
+            velocities[j] = j * (t - 100.0);
+        }
+
+        history.push(t, positions, velocities);
+
+        if (i == 0)
+        {
+            ASSERT_FALSE(history.estimateAccelerations(accelerations));
+        }
+    }
+
+    ASSERT_TRUE(history.estimateAccelerations(accelerations));
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        ASSERT_NEAR(accelerations[j], j, 1e-6);
+    }
+
+    // only the newest samples within the window are fitted
+    fill(velocities, 5.0);
+    history.push(100.1, positions, velocities);
+    history.push(100.11, positions, velocities);
+    history.push(100.12, positions, velocities);
+    history.push(100.13, positions, velocities);
+
+    ASSERT_TRUE(history.estimateAccelerations(accelerations));
+
+    for (int j = 0; j < AMOR_NUM_JOINTS; j++)
+    {
+        ASSERT_NEAR(accelerations[j], 0.0, 1e-6);
+    }
+
+    // no time variance
+    history.clear();
+    history.push(1.0, positions, velocities);
+    history.push(1.0, positions, velocities);
+    ASSERT_FALSE(history.estimateAccelerations(accelerations));
+}
+
+TEST_F(AmorControlBoardTest, SoftLimits)
+{
+    SoftLimits limits;
+    SoftLimits::Range range;
+    fill(range.lower, -1.0);
+    fill(range.upper, 1.0);
+    limits.reset(range);
+
+    AMOR_VECTOR7 values;
+    fill(values, 0.5);
+    ASSERT_EQ(limits.enforce(values, SoftLimits::ALL_JOINTS), -1);
+
+    // only the selected joints are checked
+    values[3] = 2.0;
+    values[5] = -2.0;
+    ASSERT_EQ(limits.enforce(values, SoftLimits::ALL_JOINTS), 3);
+    ASSERT_EQ(limits.enforce(values, 1u << 5), 5);
+    ASSERT_EQ(limits.enforce(values, SoftLimits::ALL_JOINTS & ~(1u << 3) & ~(1u << 5)), -1);
+    ASSERT_EQ(values[3], 2.0); // untouched unless clamping
+
+    // bounds are inclusive, NaN is always out of range
+    values[3] = 1.0;
+    values[5] = std::numeric_limits<double>::quiet_NaN();
+    ASSERT_EQ(limits.enforce(values, SoftLimits::ALL_JOINTS), 5);
+
+    // a single joint may be narrowed
+    limits.set(3, -0.5, 0.5);
+    ASSERT_EQ(limits.enforce(values, 1u << 3), 3);
+    ASSERT_EQ(limits.get().upper[3], 0.5);
+    ASSERT_EQ(limits.get().upper[4], 1.0);
+
+    limits.setClamping(true);
+
+    // NaN cannot be clamped, nothing is modified then
+    ASSERT_EQ(limits.enforce(values, SoftLimits::ALL_JOINTS), 5);
+    ASSERT_EQ(values[3], 1.0);
+
+    values[5] = -2.0;
+    values[6] = 3.0;
+    ASSERT_EQ(limits.enforce(values, SoftLimits::ALL_JOINTS & ~(1u << 6)), -1);
+    ASSERT_EQ(values[3], 0.5);
+    ASSERT_EQ(values[5], -1.0);
+    ASSERT_EQ(values[6], 3.0); // not selected
+    ASSERT_EQ(values[0], 0.5);
+}
+
+TEST_F(AmorControlBoardTest, CommandShadowPartialWrites)
+{
+    std::atomic<unsigned int> commandCounter {0};
+    CommandShadow shadow(getRequested, "getRequested", getMeasured, "getMeasured", setWritten, "setWritten", commandCounter);
+
+    fill(measured, 0.1);
+    fill(requested, 0.2);
+    fill(written, 0.0);
+    writes = 0;
+    failWrites = false;
+
+    ASSERT_FALSE(shadow.isValid());
+
+    // the first partial command builds upon the measured state
+    ASSERT_TRUE(shadow.apply(AMOR_INVALID_HANDLE, [](auto & setpoints) { setpoints[2] = 0.5; }));
+    ASSERT_EQ(writes, 1);
+    ASSERT_EQ(commandCounter, 1);
+    ASSERT_TRUE(shadow.isValid());
+    ASSERT_EQ(written[0], 0.1);
+    ASSERT_EQ(written[2], 0.5);
+
+    // the next ones upon the last setpoints, the arm is not queried again
+    fill(measured, 0.3);
+    ASSERT_TRUE(shadow.apply(AMOR_INVALID_HANDLE, [](auto & setpoints) { setpoints[4] = -0.5; }));
+    ASSERT_EQ(writes, 2);
+    ASSERT_EQ(written[0], 0.1);
+    ASSERT_EQ(written[2], 0.5);
+    ASSERT_EQ(written[4], -0.5);
+
+    // vetoed, nothing is sent nor stored
+    ASSERT_FALSE(shadow.apply(AMOR_INVALID_HANDLE, [](auto & setpoints) { setpoints[4] = 1.0; return false; }));
+    ASSERT_EQ(writes, 2);
+
+    AMOR_VECTOR7 full;
+    fill(full, 0.7);
+    ASSERT_TRUE(shadow.write(AMOR_INVALID_HANDLE, full));
+    ASSERT_TRUE(shadow.apply(AMOR_INVALID_HANDLE, [](auto & setpoints) { setpoints[1] = 0.0; }));
+    ASSERT_EQ(written[0], 0.7);
+    ASSERT_EQ(written[1], 0.0);
+    ASSERT_EQ(written[4], 0.7);
+
+    // any other command invalidates the setpoints, partial commands start over from the measured state
+    commandCounter++;
+    ASSERT_FALSE(shadow.isValid());
+    ASSERT_TRUE(shadow.apply(AMOR_INVALID_HANDLE, [](auto & setpoints) { setpoints[6] = 0.5; }));
+    ASSERT_EQ(written[0], 0.3);
+    ASSERT_EQ(written[1], 0.3);
+    ASSERT_EQ(written[6], 0.5);
+
+    // so does a failed write
+    failWrites = true;
+    ASSERT_FALSE(shadow.apply(AMOR_INVALID_HANDLE, [](auto & setpoints) { setpoints[0] = 0.0; }));
+    ASSERT_FALSE(shadow.isValid());
+    failWrites = false;
+
+    fill(measured, 0.4);
+    ASSERT_TRUE(shadow.apply(AMOR_INVALID_HANDLE, [](auto & setpoints) { setpoints[0] = 0.0; }));
+    ASSERT_EQ(written[0], 0.0);
+    ASSERT_EQ(written[6], 0.4);
+}
+
+TEST_F(AmorControlBoardTest, MotionTrackerDoneFlags)
+{
+    std::atomic<unsigned int> commandCounter {0};
+    MotionTracker tracker(commandCounter);
+    tracker.configure(0.01, 0.05);
+
+    AMOR_VECTOR7 targets, positions, velocities;
+    fill(targets, 1.0);
+    fill(positions, 0.0);
+    fill(velocities, 0.0);
+
+    bool flags[AMOR_NUM_JOINTS];
+
+    // no targets known, done once at rest
+    velocities[1] = 0.1;
+    tracker.check(positions, velocities, flags);
+    ASSERT_TRUE(flags[0]);
+    ASSERT_FALSE(flags[1]);
+
+    commandCounter++;
+    tracker.setTargets(targets);
+
+    // settled within tolerance, still moving, at rest but elsewhere
+    positions[0] = 0.995;
+    velocities[0] = 0.01;
+    positions[1] = 1.0;
+    velocities[1] = 0.1;
+    positions[2] = 0.5;
+
+    tracker.check(positions, velocities, flags);
+    ASSERT_TRUE(flags[0]);
+    ASSERT_FALSE(flags[1]);
+    ASSERT_FALSE(flags[2]);
+
+    // targets are forgotten once any other command reaches the arm
+    commandCounter++;
+    tracker.check(positions, velocities, flags);
+    ASSERT_TRUE(flags[0]);
+    ASSERT_FALSE(flags[1]);
+    ASSERT_TRUE(flags[2]);
+
+    tracker.setTargets(targets);
+    tracker.clear();
+    tracker.check(positions, velocities, flags);
+    ASSERT_TRUE(flags[2]);
+}
+
+TEST_F(AmorControlBoardTest, JointIndexValidation)
+{
+    ASSERT_TRUE(JointIndices::indexWithinRange(0));
+    ASSERT_TRUE(JointIndices::indexWithinRange(AMOR_NUM_JOINTS - 1));
+    ASSERT_FALSE(JointIndices::indexWithinRange(-1));
+    ASSERT_FALSE(JointIndices::indexWithinRange(AMOR_NUM_JOINTS));
+
+    ASSERT_TRUE(JointIndices::batchWithinRange(0)); // allowed, yet warned about
+    ASSERT_TRUE(JointIndices::batchWithinRange(AMOR_NUM_JOINTS));
+    ASSERT_FALSE(JointIndices::batchWithinRange(-1));
+    ASSERT_FALSE(JointIndices::batchWithinRange(AMOR_NUM_JOINTS + 1));
+
+    const int valid[] {0, 3, AMOR_NUM_JOINTS - 1};
+    const int negative[] {0, -1, 2};
+    const int beyond[] {0, 1, AMOR_NUM_JOINTS};
+
+    ASSERT_TRUE(JointIndices::batchWithinRange(3, valid));
+    ASSERT_FALSE(JointIndices::batchWithinRange(3, negative));
+    ASSERT_FALSE(JointIndices::batchWithinRange(3, beyond));
+    ASSERT_TRUE(JointIndices::batchWithinRange(2, beyond)); // only the first n_joint indices count
+    ASSERT_TRUE(JointIndices::batchWithinRange(0, nullptr));
+    ASSERT_FALSE(JointIndices::batchWithinRange(AMOR_NUM_JOINTS + 1, valid)); // never dereferenced
+}
+
+} // namespace roboticslab::test
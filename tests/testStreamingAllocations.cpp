@@ -0,0 +1,199 @@
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+
+#include <atomic>
+#include <new>
+#include <vector>
+
+#include <amor.h>
+
+#include "AmorBus.hpp"
+#include "DeadmanWatchdog.hpp"
+#include "IkSeedCache.hpp"
+#include "MotionStatusMonitor.hpp"
+#include "SetpointFilter.hpp"
+
+namespace
+{
+    std::atomic<std::size_t> allocations {0};
+
+    double zeroTime()
+    {
+        return 0.0;
+    }
+}
+
+// Count heap allocations performed by any thread, e.g. the bus I/O thread.
+// Array and nothrow variants forward to these by default.
+
+void * operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void * ptr = std::malloc(size ? size : 1))
+    {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void * ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace roboticslab::test
+{
+
+/**
+ * @ingroup amor_yarp_devices_tests
+ * @brief Checks that the components on the streaming path perform no heap
+ * allocations in steady state, on any thread, talking to the simulated arm.
+ */
+class StreamingAllocationsTest : public testing::Test
+{
+public:
+    void SetUp() override
+    {
+        char name[] = "libamor_api";
+        handle = amor_connect(name, 0);
+        ASSERT_NE(handle, AMOR_INVALID_HANDLE);
+    }
+
+    void TearDown() override
+    {
+        amor_release(handle);
+    }
+
+protected:
+    static constexpr int WARMUP = 10;
+    static constexpr int ITERATIONS = 1000;
+
+    //! Heap allocations performed by all threads while running fn ITERATIONS times, after a warm-up.
+    template <typename Fn>
+    static std::size_t count(Fn && fn)
+    {
+        for (int i = 0; i < WARMUP; i++)
+        {
+            fn(i);
+        }
+
+        const auto before = allocations.load();
+
+        for (int i = 0; i < ITERATIONS; i++)
+        {
+            fn(i);
+        }
+
+        return allocations.load() - before;
+    }
+
+    AMOR_HANDLE handle {AMOR_INVALID_HANDLE};
+};
+
+TEST_F(StreamingAllocationsTest, AmorBus)
+{
+    AmorBus bus(handle, zeroTime);
+    ASSERT_TRUE(bus.start());
+
+    const AmorBus::source stream {"stream", AmorBus::priority::HIGH, false, true};
+    AMOR_VECTOR7 values {};
+    bool ok = true;
+
+    const auto allocs = count([&](int i)
+        {
+            values[0] = 1e-4 * i;
+            ok = bus.call(stream, "set", [&values](AMOR_HANDLE h) { return amor_set_velocities(h, values); }) == AMOR_SUCCESS && ok;
+            ok = bus.read(stream, "read", AmorBus::read_kind::ACTUAL_POSITIONS, values) == AMOR_SUCCESS && ok;
+        });
+
+    bus.stop();
+
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(allocs, 0);
+}
+
+TEST_F(StreamingAllocationsTest, SetpointFilter)
+{
+    SetpointFilter filter;
+    filter.configure(1e-3, 0.1);
+
+    AMOR_VECTOR7 frame {};
+
+    const auto allocs = count([&](int i)
+        {
+            frame[0] = 1e-2 * (i % 2);
+
+            if (!filter.suppress(frame, 1, 1e-3 * i))
+            {
+                filter.sent(frame, 1, 1e-3 * i);
+            }
+        });
+
+    ASSERT_EQ(allocs, 0);
+    ASSERT_GT(filter.getSent(), 0);
+}
+
+TEST_F(StreamingAllocationsTest, DeadmanWatchdog)
+{
+    DeadmanWatchdog watchdog([] {});
+    ASSERT_TRUE(watchdog.start());
+
+    const auto allocs = count([&](int) { watchdog.kick(1.0); });
+
+    watchdog.stop();
+    ASSERT_EQ(allocs, 0);
+}
+
+TEST_F(StreamingAllocationsTest, IkSeedCache)
+{
+    IkSeedCache cache;
+    cache.configure(4, 0.01);
+
+    const std::vector<double> x {0.1, 0.2, 0.3, 0.0, 0.0, 0.0};
+    const std::vector<double> q0 {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+    std::vector<double> q(q0.size());
+
+    cache.store(x, q0);
+    bool hit = true;
+
+    const auto allocs = count([&](int)
+        {
+            // exact hit into a pre-sized vector, as in pose()
+            const auto seed = cache.find(x, q);
+            hit = seed == IkSeedCache::match::EXACT && hit;
+            cache.account(seed, 0, true, 1e-5);
+        });
+
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(allocs, 0);
+}
+
+TEST_F(StreamingAllocationsTest, MotionStatusMonitor)
+{
+    MotionStatusMonitor monitor([](bool & finished) { finished = true; return true; });
+    monitor.setPeriods(0.01, 0.001);
+    ASSERT_TRUE(monitor.start());
+
+    bool finished = true;
+
+    // the polling thread is woken up on every wait
+    const auto allocs = count([&](int)
+        {
+            monitor.expect(0.001);
+            finished = monitor.wait(1.0) == MotionStatusMonitor::outcome::FINISHED && finished;
+        });
+
+    monitor.stop();
+    ASSERT_TRUE(finished);
+    ASSERT_EQ(allocs, 0);
+}
+
+} // namespace roboticslab::test